@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+
+namespace wade {
+
+// Deleter for a std::unique_ptr to an object constructed with an allocator.
+// Keeps a copy of the allocator so the object can outlive whatever made it.
+template <typename Allocator_T>
+class allocator_deleter
+{
+    using traits = std::allocator_traits<Allocator_T>;
+
+public:
+
+    using allocator_type = Allocator_T;
+    using value_type = typename traits::value_type;
+
+    allocator_deleter() = default;
+    explicit allocator_deleter(allocator_type const & a_allocator)
+        : allocator_{a_allocator}
+    {
+    }
+
+    void operator()(value_type * a_value)
+    {
+        traits::destroy(allocator_, a_value);
+        traits::deallocate(allocator_, a_value, 1);
+    }
+
+private:
+
+    allocator_type allocator_{};
+};
+
+// Allocator that aligns each allocation to a given alignment (such as a cache line or SIMD register width),
+// and pads its size to a multiple of the alignment, so vectorized loops may read a whole aligned block at the end of an array.
+// Stateless, so all instances are equal.
+template <typename T, std::size_t Alignment = 64>
+class aligned_allocator
+{
+    static_assert(Alignment >= alignof(T) and (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2 that is at least the type's alignment");
+    static_assert(Alignment >= sizeof(void *), "Alignment must leave room to store the allocated address");
+
+public:
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    static constexpr std::size_t alignment = Alignment;
+
+    aligned_allocator() = default;
+    template <typename U>
+    aligned_allocator(aligned_allocator<U, Alignment> const &) {}
+
+    T * allocate(std::size_t a_count)
+    {
+        // Over-allocate to align, and store the allocated address just before the aligned address.
+        // Note: the gap is at least the fundamental alignment of operator new, so there is always room for the address.
+        std::size_t const size = (a_count * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        void * memory = ::operator new(size + Alignment);
+        std::uintptr_t const aligned = (reinterpret_cast<std::uintptr_t>(memory) + Alignment) & ~std::uintptr_t{Alignment - 1};
+        reinterpret_cast<void **>(aligned)[-1] = memory;
+        return reinterpret_cast<T *>(aligned);
+    }
+
+    void deallocate(T * a_value, std::size_t)
+    {
+        ::operator delete(reinterpret_cast<void **>(a_value)[-1]);
+    }
+
+    template <typename U>
+    bool operator==(aligned_allocator<U, Alignment> const &) const { return true; }
+    template <typename U>
+    bool operator!=(aligned_allocator<U, Alignment> const &) const { return false; }
+};
+
+template <typename T, std::size_t Alignment>
+constexpr std::size_t aligned_allocator<T, Alignment>::alignment;
+
+// Storage for the allocator of a class that is meant to be used as a base class.
+// A stateless (empty) allocator is not stored at all but is default-constructed when needed.
+// Member names are prefixed to avoid colliding with the names of the derived class.
+template <typename Allocator_T, bool = std::is_empty<Allocator_T>::value>
+class allocator_holder
+{
+public:
+
+    Allocator_T const & tracker_allocator() const { return tracker_allocator_; }
+
+protected:
+
+    allocator_holder() = default;
+    explicit allocator_holder(Allocator_T const & a_allocator)
+        : tracker_allocator_{a_allocator}
+    {
+    }
+
+private:
+
+    Allocator_T tracker_allocator_{};
+};
+
+template <typename Allocator_T>
+class allocator_holder<Allocator_T, true>
+{
+public:
+
+    Allocator_T tracker_allocator() const { return Allocator_T{}; }
+
+protected:
+
+    allocator_holder() = default;
+    explicit allocator_holder(Allocator_T const &) {}
+};
+
+}
+
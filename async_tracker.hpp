@@ -0,0 +1,363 @@
+#pragma once
+
+#include "tracker.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <array>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+// Aliases for long template names (not part of interface and will be undefined).
+#define ASYNC_TRACKER_TEMPLATE_DECL template <typename Derived, typename Tracked_T, typename Container_T = std::vector<Tracked_T *>, typename Allocator_T = std::allocator<Tracked_T>, std::size_t Lane_Count = 64>
+#define ASYNC_TRACKER_TEMPLATE template <typename Derived, typename Tracked_T, typename Container_T, typename Allocator_T, std::size_t Lane_Count>
+#define ASYNC_TRACKER_TYPE async_tracker<Derived, Tracked_T, Container_T, Allocator_T, Lane_Count>
+
+// Tracker that calls the derived class's did_make() and did_attach() asynchronously on a work_stealing_pool,
+// so making and attaching objects does not wait for those methods. Each method is optional, like wade::tracker's, and is neither queued nor called if not defined. For example:
+//   struct Mytracker : wade::async_tracker<Mytracker, MyClass>
+//   {
+//       explicit Mytracker(wade::work_stealing_pool & a_pool) : async_tracker{a_pool} {}
+//       void did_make(MyClass &); void did_attach(MyClass &); void did_detach(MyClass &);
+//   };
+// Otherwise it is used like wade::tracker (and is one), except that it is not moveable since queued methods refer to it.
+// The batch methods (did_make_batch(), did_attach_batch(), and did_detach_batch()) are optional too, and are queued or called like the others,
+// except that did_make_batch() and did_attach_batch() are called once for the objects of each lane rather than once for the whole batch.
+//
+// Methods for each object are called in order (make, then attach, then detach) since objects are assigned to one of Lane_Count lanes
+// by their address, and each lane's methods are called one at a time in the order they were queued.
+// Methods for objects in different lanes may be called at the same time on different threads, so they must be thread-safe,
+// and must not attach or detach any object (or block on anything queued in the same pool).
+// Since a detached object may be deleted as soon as it is detached (and is, when deleting detaches it),
+// detaching waits for the methods already queued in the object's lane and then calls did_detach() directly, so no queued method outlives the object.
+// Call flush() to wait for all queued methods, such as before reading state that the methods update.
+// The derived class should call flush() in its destructor if queued methods use its members.
+ASYNC_TRACKER_TEMPLATE_DECL
+class async_tracker
+    : public tracker<ASYNC_TRACKER_TYPE, Tracked_T, Container_T, Allocator_T>
+{
+    static_assert(Lane_Count > 0 and (Lane_Count & (Lane_Count - 1)) == 0, "Lane_Count must be a power of 2");
+
+    using base_type = tracker<async_tracker, Tracked_T, Container_T, Allocator_T>;
+    friend base_type;
+
+public:
+
+    using typename base_type::tracked_type;
+    using typename base_type::tracked_span;
+    using typename base_type::size_type;
+
+    static constexpr size_type lane_count = Lane_Count;
+
+    // Neither copyable nor moveable since queued methods refer to the tracker.
+    explicit async_tracker(work_stealing_pool & a_pool)
+        : pool_(a_pool)
+    {
+    }
+    async_tracker(async_tracker const &) = delete;
+    async_tracker & operator=(async_tracker const &) = delete;
+    async_tracker(async_tracker &&) = delete;
+    async_tracker & operator=(async_tracker &&) = delete;
+
+    // Wait until all queued methods have been called.
+    void flush();
+
+    // Get the pool that calls queued methods.
+    work_stealing_pool & pool() const { return pool_; }
+
+protected:
+
+    // Destructor waits for queued methods, then detaches all objects.
+    ~async_tracker();
+
+private:
+
+    // Implement wade::tracker by queuing derived methods, except for detaching, which waits and then calls directly.
+    void did_make(tracked_type &);
+    void did_attach(tracked_type &);
+    void did_detach(tracked_type &);
+    void did_make_batch(tracked_span);
+    void did_attach_batch(tracked_span);
+    void did_detach_batch(tracked_span);
+
+    // Whether the derived class defines a method itself, rather than only inheriting the method above that queues it,
+    // which OPTIONAL_STATIC_DISPATCH would find (and so call itself).
+    // Note: a method of the derived class hides the one above, so only an inherited method is a pointer to a member of this class.
+#define ASYNC_TRACKER_DEFINE_HAS_OWN(FUNC, ARG) \
+    template <typename T, typename = void> \
+    struct has_own_##FUNC : std::true_type {}; \
+    template <typename T> \
+    struct has_own_##FUNC<T, decltype((void)&T::FUNC)> : std::integral_constant<bool, not std::is_same<decltype(&T::FUNC), void (async_tracker::*)(ARG)>::value> {}
+    ASYNC_TRACKER_DEFINE_HAS_OWN(did_make, tracked_type &);
+    ASYNC_TRACKER_DEFINE_HAS_OWN(did_attach, tracked_type &);
+    ASYNC_TRACKER_DEFINE_HAS_OWN(did_detach, tracked_type &);
+    ASYNC_TRACKER_DEFINE_HAS_OWN(did_make_batch, tracked_span);
+    ASYNC_TRACKER_DEFINE_HAS_OWN(did_attach_batch, tracked_span);
+    ASYNC_TRACKER_DEFINE_HAS_OWN(did_detach_batch, tracked_span);
+#undef ASYNC_TRACKER_DEFINE_HAS_OWN
+
+    // Method to call for an object.
+    // Consecutive batch events of the same kind in a lane are called together as one batch.
+    enum class event
+    {
+        make,
+        attach,
+        make_batch,
+        attach_batch,
+    };
+
+    // Queue of methods that are called in order by at most one task at a time.
+    struct lane
+    {
+        std::mutex mutex{};
+        std::condition_variable idle{};
+        std::deque<std::pair<event, tracked_type *> > events{};
+        bool scheduled = false;
+    };
+
+    lane & lane_of(tracked_type const *);
+
+    // Queue a method, and schedule a task to call the lane's methods if none is already scheduled.
+    void post(event, tracked_type &);
+
+    // Call a lane's methods until none are left. Run by a task on the pool.
+    void drain(lane &);
+
+    // Wait until a lane has no queued methods and no task is calling them.
+    void wait(lane &);
+
+    work_stealing_pool & pool_;
+    std::array<lane, Lane_Count> lanes_{};
+};
+
+ASYNC_TRACKER_TEMPLATE
+constexpr typename ASYNC_TRACKER_TYPE::size_type ASYNC_TRACKER_TYPE::lane_count;
+
+ASYNC_TRACKER_TEMPLATE
+ASYNC_TRACKER_TYPE::
+~async_tracker()
+{
+    // Note: must detach here since the base destructor would call did_detach() after the lanes are destroyed.
+    flush();
+    this->detach_all();
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+flush()
+{
+    for (auto && a_lane : lanes_)
+    {
+        wait(a_lane);
+    }
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+did_make(tracked_type & a_tracked)
+{
+    if (has_own_did_make<Derived>::value)
+    {
+        post(event::make, a_tracked);
+    }
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+did_attach(tracked_type & a_tracked)
+{
+    if (has_own_did_attach<Derived>::value)
+    {
+        post(event::attach, a_tracked);
+    }
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+did_detach(tracked_type & a_tracked)
+{
+    wait(lane_of(&a_tracked));
+    if (has_own_did_detach<Derived>::value)
+    {
+        STATIC_DISPATCH(Derived, did_detach, a_tracked);
+    }
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+did_make_batch(tracked_span a_objects)
+{
+    // Queue each object in its own lane, falling back to the method for each object if the derived class only defines that.
+    for (auto && a_tracked : a_objects)
+    {
+        if (has_own_did_make_batch<Derived>::value)
+        {
+            post(event::make_batch, *a_tracked);
+        }
+        else if (has_own_did_make<Derived>::value)
+        {
+            post(event::make, *a_tracked);
+        }
+    }
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+did_attach_batch(tracked_span a_objects)
+{
+    for (auto && a_tracked : a_objects)
+    {
+        if (has_own_did_attach_batch<Derived>::value)
+        {
+            post(event::attach_batch, *a_tracked);
+        }
+        else if (has_own_did_attach<Derived>::value)
+        {
+            post(event::attach, *a_tracked);
+        }
+    }
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+did_detach_batch(tracked_span a_objects)
+{
+    // Note: called once for the whole batch, since it is called directly after waiting for every object's lane.
+    for (auto && a_tracked : a_objects)
+    {
+        wait(lane_of(a_tracked));
+    }
+    if (has_own_did_detach_batch<Derived>::value)
+    {
+        STATIC_DISPATCH(Derived, did_detach_batch, a_objects);
+    }
+    else if (has_own_did_detach<Derived>::value)
+    {
+        for (auto && a_tracked : a_objects)
+        {
+            STATIC_DISPATCH(Derived, did_detach, *a_tracked);
+        }
+    }
+}
+
+ASYNC_TRACKER_TEMPLATE
+typename ASYNC_TRACKER_TYPE::lane &
+ASYNC_TRACKER_TYPE::
+lane_of(tracked_type const * a_tracked)
+{
+    auto const address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(a_tracked));
+    auto const hash = address * UINT64_C(11400714819323198485);
+    return lanes_[static_cast<size_type>(hash >> 32) & (Lane_Count - 1)];
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+post(event an_event, tracked_type & a_tracked)
+{
+    lane & a_lane = lane_of(&a_tracked);
+    {
+        std::lock_guard<std::mutex> lock{a_lane.mutex};
+        a_lane.events.emplace_back(an_event, &a_tracked);
+        if (a_lane.scheduled)
+        {
+            return;
+        }
+        a_lane.scheduled = true;
+    }
+
+    // If the pool cannot take the task (i.e., allocating it throws), call the lane's methods on this thread instead,
+    // which unschedules the lane, so no method is left queued without a task and waiting for the lane does not hang.
+    try
+    {
+        pool_.submit([this, &a_lane] { drain(a_lane); });
+    }
+    catch (...)
+    {
+        drain(a_lane);
+    }
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+drain(lane & a_lane)
+{
+    // Keep the lane scheduled while calling a method so that methods of the same lane are never called at the same time.
+    std::vector<tracked_type *> batch{};
+    for (;;)
+    {
+        std::pair<event, tracked_type *> an_event{};
+        {
+            std::lock_guard<std::mutex> lock{a_lane.mutex};
+            if (a_lane.events.empty())
+            {
+                a_lane.scheduled = false;
+                a_lane.idle.notify_all();
+                return;
+            }
+            an_event = a_lane.events.front();
+            a_lane.events.pop_front();
+
+            // Take all consecutive objects of a batch at once.
+            batch.clear();
+            if (an_event.first == event::make_batch or an_event.first == event::attach_batch)
+            {
+                batch.push_back(an_event.second);
+                for (; not a_lane.events.empty() and a_lane.events.front().first == an_event.first; a_lane.events.pop_front())
+                {
+                    batch.push_back(a_lane.events.front().second);
+                }
+            }
+        }
+        // Note: only events for methods that the derived class defines are queued.
+        switch (an_event.first)
+        {
+        case event::make:
+            STATIC_DISPATCH(Derived, did_make, *an_event.second);
+            break;
+        case event::attach:
+            STATIC_DISPATCH(Derived, did_attach, *an_event.second);
+            break;
+        case event::make_batch:
+            STATIC_DISPATCH(Derived, did_make_batch, tracked_span{batch.data(), batch.size()});
+            break;
+        case event::attach_batch:
+            STATIC_DISPATCH(Derived, did_attach_batch, tracked_span{batch.data(), batch.size()});
+            break;
+        }
+    }
+}
+
+ASYNC_TRACKER_TEMPLATE
+void
+ASYNC_TRACKER_TYPE::
+wait(lane & a_lane)
+{
+    std::unique_lock<std::mutex> lock{a_lane.mutex};
+    a_lane.idle.wait(lock, [&a_lane] { return not a_lane.scheduled; });
+}
+
+#undef ASYNC_TRACKER_TYPE
+#undef ASYNC_TRACKER_TEMPLATE
+#undef ASYNC_TRACKER_TEMPLATE_DECL
+
+}
+
@@ -0,0 +1,504 @@
+#pragma once
+
+#include "hook.hpp"
+#include "static_dispatch.hpp"
+#include "unordered_vector.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace wade {
+
+// Aliases for long template names (not part of interface and will be undefined).
+// The container for each shard is customizable like the tracker's, but defaults to an unordered vector
+// since tracked objects have no overall order across shards anyway, and detaching should be done quickly while the shard is locked.
+#define CONCURRENT_TRACKER_TEMPLATE_DECL template <typename Derived, typename Tracked_T, typename Container_T = wade::unordered_vector<Tracked_T *>, std::size_t Shard_Count = 16>
+#define CONCURRENT_TRACKER_TEMPLATE template <typename Derived, typename Tracked_T, typename Container_T, std::size_t Shard_Count>
+#define CONCURRENT_TRACKER_TYPE concurrent_tracker<Derived, Tracked_T, Container_T, Shard_Count>
+
+// Macro for defining a concurrent tracker with a custom container, like TRACKER_WITH_CONTAINER. For example:
+//   CONCURRENT_TRACKER_WITH_CONTAINER(Mytracker, MyClass, std::vector)
+#define CONCURRENT_TRACKER_WITH_CONTAINER(TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE) \
+    wade::concurrent_tracker<TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE<TRACKED_TYPE *> >
+
+// Factory that tracks made objects, like wade::tracker, but whose objects may be made, attached, and detached from multiple threads.
+// Tracked objects are split among a number of shards by their address, and each shard has its own container and mutex,
+// so threads working on different objects rarely contend for the same lock.
+// Since objects may be attached and detached at any time, instead of a container reference, tracked objects are accessed
+// with for_each(), which visits each shard while it is locked, or snapshot(), which copies pointers to all objects.
+//
+// The derived class may define the same methods as for wade::tracker (and methods that are not defined are not called), which must be thread-safe:
+//   void did_make(Tracked_T &); // Called by make() after constructing and attaching an object.
+//   void did_attach(Tracked_T &); // Called by attach() after an object is attached (but not by make()).
+//   void did_detach(Tracked_T &); // Called by detach() after an object is detached.
+// These are called by the thread that made, attached, or detached the object, without holding any lock,
+// except that detach_all() calls did_detach() while the object's shard is locked, so it must not attach or detach any object.
+// An object is also still claimed (see below) while did_detach() is called, so it must not attach or detach that object.
+//
+// Each object's tracker pointer is atomic, and every change of ownership first claims the object by swapping its tracker pointer
+// from the expected tracker (or nullptr) to a claimed marker using compare-and-swap.
+// Only the thread that claimed an object may change its shard's container or notify the tracker,
+// so threads racing to attach, detach, or move the same object between trackers serialize on the object itself:
+// exactly one of them succeeds for each change, and the others see the result instead of corrupting a container.
+// Other threads that need the object (including its destructor) wait until the claim is released, which keeps the object alive while it is claimed.
+// Checking whether an object is attached and detaching a detached object are lock-free.
+// The tracker must outlive any concurrent operations on its objects.
+CONCURRENT_TRACKER_TEMPLATE_DECL
+class concurrent_tracker
+{
+    static_assert(Shard_Count > 0 and (Shard_Count & (Shard_Count - 1)) == 0, "Shard_Count must be a power of 2");
+
+public:
+
+    using tracked_type = Tracked_T;
+    using hook_type = wade::hook_type<Container_T>;
+    using size_type = std::size_t;
+
+    static constexpr size_type shard_count = Shard_Count;
+
+    // Neither copyable nor moveable since objects may be attaching or detaching concurrently.
+    concurrent_tracker() = default;
+    concurrent_tracker(concurrent_tracker const &) = delete;
+    concurrent_tracker & operator=(concurrent_tracker const &) = delete;
+
+    // Object being tracked.
+    // Detaches itself from its tracker when destroyed.
+    class trackable
+        : public tracked_type
+        , private hook_holder<hook_type>
+    {
+        // Metafunction helper.
+        template <bool B, typename T = void>
+        using disable_if = std::enable_if<not B, T>;
+
+    public:
+
+        trackable() = default;
+
+        // Constructible with any number of arguments which are forwarded to base,
+        // but disable this ctor for default and copy ctors.
+        // Detached by default.
+        template <typename Arg, typename ...Args, typename = typename
+            disable_if<
+                sizeof...(Args) == 0
+                and std::is_same<typename std::decay<Arg>::type, trackable>::value
+            >::type
+        >
+        trackable(Arg && arg, Args && ...args)
+            : tracked_type{std::forward<Arg>(arg), std::forward<Args>(args)...}
+            , tracker_{nullptr}
+        {
+        }
+
+        // Copying attaches to the same tracker.
+        trackable(trackable const & rhs)
+            : tracked_type{rhs}
+            , hook_holder<hook_type>{}
+            , tracker_{nullptr}
+        {
+            if (auto && tracker = rhs.my_tracker())
+            {
+                tracker->attach(this);
+            }
+        }
+        trackable & operator=(trackable const & rhs)
+        {
+            if (this != &rhs)
+            {
+                tracked_type::operator=(rhs);
+
+                // Attaching moves this from any other tracker.
+                if (auto && tracker = rhs.my_tracker())
+                {
+                    tracker->attach(this);
+                }
+                else
+                {
+                    detach();
+                }
+            }
+            return *this;
+        }
+
+        // Moving transfers the tracker.
+        // The tracker is whichever one rhs is actually detached from, even if another thread moves rhs at the same time.
+        trackable(trackable && rhs)
+            : tracked_type{std::move(rhs)}
+            , tracker_{nullptr}
+        {
+            if (auto && tracker = rhs.release())
+            {
+                tracker->attach(this);
+            }
+        }
+        trackable & operator=(trackable && rhs)
+        {
+            assert(this != &rhs);
+            tracked_type::operator=(std::move(rhs));
+            if (auto && tracker = rhs.release())
+            {
+                tracker->attach(this);
+            }
+            else
+            {
+                detach();
+            }
+            return *this;
+        }
+
+        // Deleting detaches from the tracker.
+        ~trackable()
+        {
+            detach();
+        }
+
+        // Detach this object.
+        // Returns true if successful and false otherwise (including if another thread detached it first).
+        bool detach() { return release() != nullptr; }
+
+        // Get this tracker. Returns nullptr if not attached, including while another thread has claimed this object.
+        concurrent_tracker * my_tracker() const
+        {
+            auto && tracker = tracker_.load(std::memory_order_acquire);
+            return tracker == claimed() ? nullptr : tracker;
+        }
+
+        // Whether this object is attached to any tracker or not.
+        bool is_attached() const { return my_tracker() != nullptr; }
+        bool is_detached() const { return not is_attached(); }
+
+        // Get the data stored in this object by the shard's container. Only meaningful while attached.
+        hook_type const & my_hook() const { return this->tracker_hook(); }
+
+    private:
+
+        friend class concurrent_tracker;
+
+        // Detach this object, waiting for any other thread that has claimed it.
+        // Returns the tracker it was detached from, or nullptr if it was already detached.
+        concurrent_tracker * release()
+        {
+            for (;;)
+            {
+                auto && tracker = tracker_.load(std::memory_order_acquire);
+                if (not tracker)
+                {
+                    return nullptr;
+                }
+                if (tracker == claimed())
+                {
+                    std::this_thread::yield();
+                }
+                else if (tracker->detach(this))
+                {
+                    return tracker;
+                }
+            }
+        }
+
+        // Non-owning pointer to tracker, or claimed() while a thread is changing its ownership.
+        // Detached by default.
+        std::atomic<concurrent_tracker *> tracker_{nullptr};
+    };
+
+    using trackable_ptr = std::unique_ptr<trackable>;
+
+    // Make an attached object.
+    // Calls did_make() after constructing and attaching.
+    template <typename ...Args>
+    trackable_ptr make(Args && ...args);
+
+    // Attach an object.
+    // Calls did_attach() if successful.
+    // Returns true if successful and false otherwise.
+    bool attach(trackable_ptr & a_trackable) { return attach(a_trackable.get()); }
+    bool attach(trackable *);
+
+    // Detach an object.
+    // Calls did_detach() if successful.
+    // Returns true if successful and false otherwise.
+    bool detach(trackable_ptr & a_trackable) { return detach(a_trackable.get()); }
+    bool detach(trackable *);
+
+    // Detach all objects.
+    void detach_all();
+
+    // Whether the object is attached to this tracker or not.
+    bool is_attached(trackable_ptr const & a_trackable) const { return is_attached(a_trackable.get()); }
+    bool is_attached(trackable const * a_trackable) const { return a_trackable and (a_trackable->my_tracker() == this); }
+    bool is_detached(trackable_ptr const & a_trackable) const { return not is_attached(a_trackable); }
+    bool is_detached(trackable const * a_trackable) const { return not is_attached(a_trackable); }
+
+    // Number of attached objects, which may be out of date by the time it returns if other threads are attaching or detaching.
+    size_type size() const;
+
+    // Call a function with each attached object as a Tracked_T &.
+    // Each shard is locked while its objects are visited, so the function must not attach or detach any object.
+    template <typename Function>
+    void for_each(Function &&) const;
+
+    // Get pointers to all attached objects.
+    // Objects may be detached or deleted by other threads after this returns, so the caller must ensure they are still alive.
+    std::vector<tracked_type *> snapshot() const;
+
+protected:
+
+    // Destructor detaches (but does not delete) all objects.
+    // Protected destructor since should not have a tracker base class pointer to a derived class instance.
+    ~concurrent_tracker();
+
+private:
+
+    using container_type = Container_T;
+
+    // Container and its lock, padded to separate cache lines to avoid false sharing between threads using different shards.
+    struct alignas(64) shard
+    {
+        mutable std::mutex mutex{};
+        container_type tracked_objects{};
+    };
+
+    // Call the derived class's methods only if defined.
+    DEFINE_OPTIONAL_DISPATCH(did_make);
+    DEFINE_OPTIONAL_DISPATCH(did_attach);
+    DEFINE_OPTIONAL_DISPATCH(did_detach);
+
+    // Get the shard of an object from its address.
+    // Uses Fibonacci hashing to spread nearby addresses across shards.
+    shard & shard_of(trackable const *);
+
+    // Marker for an object whose ownership is being changed by a thread.
+    // Never the address of a tracker since trackers are aligned like their shards.
+    static concurrent_tracker * claimed() { return reinterpret_cast<concurrent_tracker *>(std::uintptr_t{1}); }
+
+    // Internal methods to connect or disconnect an object that has already been claimed.
+    void connect(trackable *);
+    void disconnect(trackable *);
+
+    // Accessor given to containers to find the hook of a tracked object.
+    struct hook_of
+    {
+        hook_type & operator()(tracked_type * a_tracked) const { return static_cast<trackable *>(a_tracked)->tracker_hook(); }
+    };
+
+    std::array<shard, Shard_Count> shards_{};
+};
+
+CONCURRENT_TRACKER_TEMPLATE
+constexpr typename CONCURRENT_TRACKER_TYPE::size_type CONCURRENT_TRACKER_TYPE::shard_count;
+
+CONCURRENT_TRACKER_TEMPLATE
+CONCURRENT_TRACKER_TYPE::
+~concurrent_tracker()
+{
+    detach_all();
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+template <typename ...Args>
+typename CONCURRENT_TRACKER_TYPE::trackable_ptr
+CONCURRENT_TRACKER_TYPE::
+make(Args && ...args)
+{
+    // Make, attach, and notify.
+    // Note: the new object is not visible to other threads yet, so does not need to be claimed.
+    auto && a_trackable = std::make_unique<trackable>(std::forward<Args>(args)...);
+    connect(a_trackable.get());
+    OPTIONAL_STATIC_DISPATCH(Derived, did_make, *a_trackable);
+    return std::move(a_trackable);
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+bool
+CONCURRENT_TRACKER_TYPE::
+attach(trackable * a_trackable)
+{
+    if (not a_trackable)
+    {
+        return false;
+    }
+
+    // Claim the object once it is detached.
+    concurrent_tracker * expected = nullptr;
+    while (not a_trackable->tracker_.compare_exchange_weak(expected, claimed(), std::memory_order_acquire, std::memory_order_acquire))
+    {
+        if (expected == this)
+        {
+            // Do nothing if already attached to this.
+            return false;
+        }
+        else if (expected == claimed())
+        {
+            // Wait for another thread to finish with the object.
+            std::this_thread::yield();
+        }
+        else if (expected)
+        {
+            // Detach in case already attached to another, which fails if another thread detaches it first.
+            expected->detach(a_trackable);
+        }
+        expected = nullptr;
+    }
+
+    connect(a_trackable);
+    OPTIONAL_STATIC_DISPATCH(Derived, did_attach, *a_trackable);
+    return true;
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+bool
+CONCURRENT_TRACKER_TYPE::
+detach(trackable * a_trackable)
+{
+    // Do nothing if not attached to this, including if another thread claimed the object first.
+    concurrent_tracker * expected = this;
+    if (not a_trackable or not a_trackable->tracker_.compare_exchange_strong(expected, claimed(), std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    // Notify before releasing the claim so the object cannot be deleted by another thread yet.
+    disconnect(a_trackable);
+    OPTIONAL_STATIC_DISPATCH(Derived, did_detach, *a_trackable);
+    a_trackable->tracker_.store(nullptr, std::memory_order_release);
+    return true;
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+void
+CONCURRENT_TRACKER_TYPE::
+detach_all()
+{
+    // Detach all objects one shard at a time.
+    // Objects claimed by other threads are waiting for the lock to disconnect themselves, so they are kept in the container.
+    std::vector<tracked_type *> claimed_objects{};
+    std::vector<trackable *> kept_objects{};
+    for (auto && a_shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock{a_shard.mutex};
+        claimed_objects.clear();
+        kept_objects.clear();
+        for (auto && a_tracked : a_shard.tracked_objects)
+        {
+            auto && a_trackable = static_cast<trackable *>(a_tracked);
+            concurrent_tracker * expected = this;
+            if (a_trackable->tracker_.compare_exchange_strong(expected, claimed(), std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                claimed_objects.push_back(a_trackable);
+            }
+            else
+            {
+                kept_objects.push_back(a_trackable);
+            }
+        }
+        a_shard.tracked_objects.clear();
+        for (auto && a_trackable : kept_objects)
+        {
+            wade::insert(a_shard.tracked_objects, a_trackable, hook_of{});
+        }
+
+        // Notify while still claimed since an object's owner may delete it as soon as it is detached.
+        for (auto && a_tracked : claimed_objects)
+        {
+            OPTIONAL_STATIC_DISPATCH(Derived, did_detach, *a_tracked);
+            static_cast<trackable *>(a_tracked)->tracker_.store(nullptr, std::memory_order_release);
+        }
+    }
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+typename CONCURRENT_TRACKER_TYPE::size_type
+CONCURRENT_TRACKER_TYPE::
+size() const
+{
+    size_type size = 0;
+    for (auto && a_shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock{a_shard.mutex};
+        size += a_shard.tracked_objects.size();
+    }
+    return size;
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+template <typename Function>
+void
+CONCURRENT_TRACKER_TYPE::
+for_each(Function && a_function) const
+{
+    for (auto && a_shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock{a_shard.mutex};
+        for (auto && a_tracked : a_shard.tracked_objects)
+        {
+            a_function(*a_tracked);
+        }
+    }
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+std::vector<typename CONCURRENT_TRACKER_TYPE::tracked_type *>
+CONCURRENT_TRACKER_TYPE::
+snapshot() const
+{
+    std::vector<tracked_type *> objects{};
+    for (auto && a_shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock{a_shard.mutex};
+        objects.insert(std::end(objects), std::begin(a_shard.tracked_objects), std::end(a_shard.tracked_objects));
+    }
+    return objects;
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+typename CONCURRENT_TRACKER_TYPE::shard &
+CONCURRENT_TRACKER_TYPE::
+shard_of(trackable const * a_trackable)
+{
+    auto const address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(a_trackable));
+    auto const hash = address * UINT64_C(11400714819323198485);
+    return shards_[static_cast<size_type>(hash >> 32) & (Shard_Count - 1)];
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+void
+CONCURRENT_TRACKER_TYPE::
+connect(trackable * a_trackable)
+{
+    // Connect object and tracker together, which releases the claim.
+    assert(a_trackable and a_trackable->tracker_.load(std::memory_order_relaxed) != this);
+    {
+        shard & a_shard = shard_of(a_trackable);
+        std::lock_guard<std::mutex> lock{a_shard.mutex};
+        wade::insert(a_shard.tracked_objects, a_trackable, hook_of{});
+    }
+    a_trackable->tracker_.store(this, std::memory_order_release);
+}
+
+CONCURRENT_TRACKER_TEMPLATE
+void
+CONCURRENT_TRACKER_TYPE::
+disconnect(trackable * a_trackable)
+{
+    // Disconnect object from tracker, but leave the object claimed.
+    assert(a_trackable and a_trackable->tracker_.load(std::memory_order_relaxed) == claimed());
+    shard & a_shard = shard_of(a_trackable);
+    std::lock_guard<std::mutex> lock{a_shard.mutex};
+    wade::erase(a_shard.tracked_objects, a_trackable, hook_of{});
+}
+
+#undef CONCURRENT_TRACKER_TYPE
+#undef CONCURRENT_TRACKER_TEMPLATE
+#undef CONCURRENT_TRACKER_TEMPLATE_DECL
+
+}
+
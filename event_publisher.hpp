@@ -0,0 +1,103 @@
+#pragma once
+
+#include "mpsc_ring.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+
+namespace wade {
+
+// Kind of change to a tracker's objects.
+enum class tracker_event_kind
+{
+    make,
+    attach,
+    detach,
+};
+
+// Change to a tracker's objects.
+// The object is only an identity, since it may be destroyed (or even reused at the same address) by the time the event is consumed.
+template <typename Tracked_T>
+struct tracker_event
+{
+    tracker_event_kind kind = tracker_event_kind::make;
+    Tracked_T * object = nullptr;
+};
+
+// Overflow policy that waits for room when the ring is full, so no event is ever lost, which event_publisher uses by default.
+// An overflow policy is given as the last template parameter of event_publisher, and must define:
+//   template <typename Ring_T, typename Value_T> static bool push(Ring_T &, Value_T); // Push a value, returning false if it was dropped.
+struct wait_when_full
+{
+    template <typename Ring_T, typename Value_T>
+    static bool push(Ring_T & a_ring, Value_T a_value)
+    {
+        a_ring.push(std::move(a_value));
+        return true;
+    }
+};
+
+// Overflow policy that drops an event when the ring is full instead of waiting, so publishing never blocks,
+// such as when the consumer is the thread that changes the tracker.
+struct drop_when_full
+{
+    template <typename Ring_T, typename Value_T>
+    static bool push(Ring_T & a_ring, Value_T a_value)
+    {
+        return a_ring.try_push(std::move(a_value));
+    }
+};
+
+// Mixin that implements a tracker's required methods by publishing every change to a lock-free mpsc_ring,
+// which a consumer thread drains in batches. For example:
+//   struct Mytracker : wade::event_publisher<MyClass>, wade::tracker<Mytracker, MyClass> {};
+//   tracker.events().drain([](wade::tracker_event<MyClass> an_event) { ... });
+// List the mixin before the tracker so the ring outlives the tracker, whose destructor publishes detach events.
+// Works with any tracker, including wade::concurrent_tracker, whose methods are called from multiple threads.
+// By default, publishing waits for room when the ring is full, so every change is delivered, but the consumer must keep draining on another thread
+// while changes that do not fit are published (including detaching all objects or destroying the tracker), or publishing waits forever.
+// With wade::drop_when_full, publishing never waits, and an event is dropped when the ring is full and counted by dropped_count().
+// A consumer that sees drops should resynchronize (i.e., from tracked_objects()).
+template <typename Tracked_T, std::size_t Capacity = 1024, typename Overflow_T = wait_when_full>
+class event_publisher
+{
+public:
+
+    using event_type = tracker_event<Tracked_T>;
+    using ring_type = mpsc_ring<event_type, Capacity>;
+
+    // Implement wade::tracker.
+    void did_make(Tracked_T & a_tracked) { publish(tracker_event_kind::make, a_tracked); }
+    void did_attach(Tracked_T & a_tracked) { publish(tracker_event_kind::attach, a_tracked); }
+    void did_detach(Tracked_T & a_tracked) { publish(tracker_event_kind::detach, a_tracked); }
+
+    // Get the published events, which must only be consumed by one thread.
+    ring_type & events() { return events_; }
+
+    // Number of events dropped because the ring was full, which is always 0 unless the overflow policy drops events.
+    std::size_t dropped_count() const { return dropped_count_.load(std::memory_order_relaxed); }
+
+protected:
+
+    // Protected since should not have a mixin base class pointer to a derived class instance.
+    event_publisher() = default;
+    ~event_publisher() = default;
+
+private:
+
+    void publish(tracker_event_kind a_kind, Tracked_T & a_tracked)
+    {
+        if (not Overflow_T::push(events_, event_type{a_kind, &a_tracked}))
+        {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    ring_type events_{};
+    std::atomic<std::size_t> dropped_count_{0};
+};
+
+}
+
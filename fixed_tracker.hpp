@@ -0,0 +1,59 @@
+#pragma once
+
+#include "fixed_unordered_vector.hpp"
+#include "object_pool.hpp"
+#include "tracker.hpp"
+
+#include <cstddef>
+#include <memory>
+
+
+namespace wade {
+
+// Tracker of up to Capacity objects, which allocates all its storage once it is constructed and never again while making, attaching, or detaching.
+// Objects are attached to a fixed_unordered_vector and made in the single slab of a fixed_allocator, so each takes constant time. For example:
+//   struct Mytracker : wade::fixed_tracker<Mytracker, MyClass, 1024>
+//   {
+//       void did_make(MyClass &); void did_attach(MyClass &); void did_detach(MyClass &);
+//   };
+// Otherwise it is used like wade::tracker (and is one), except that it reports running out of room instead of growing:
+// make() returns nullptr and attach() returns false once the tracker is full (see is_full()), and batches stop early.
+// Only make_owned(), make_n(), make_each(), and publish() still allocate, for the lists they return or keep.
+// Objects may be marked dirty with a dirty policy (see tracker_dirty.hpp), whose list is also allocated up front.
+template <typename Derived, typename Tracked_T, std::size_t Capacity, typename Dirty_T = no_dirty_list>
+class fixed_tracker
+    : public tracker<Derived, Tracked_T, fixed_unordered_vector<Tracked_T *, Capacity>, fixed_allocator<Tracked_T, Capacity>, no_stats, pointer_link, Dirty_T>
+{
+    static_assert(Capacity > 0, "Must have room for at least one object");
+
+    using base_type = tracker<Derived, Tracked_T, fixed_unordered_vector<Tracked_T *, Capacity>, fixed_allocator<Tracked_T, Capacity>, no_stats, pointer_link, Dirty_T>;
+
+public:
+
+    using typename base_type::size_type;
+
+    static constexpr size_type capacity = Capacity;
+
+protected:
+
+    // Allocate the objects' slab and the dirty list up front.
+    fixed_tracker()
+        : base_type{fixed_allocator<Tracked_T, Capacity>::make_pool()}
+    {
+        this->reserve(Capacity);
+        typename base_type::trackable_allocator_type{this->get_allocator()}.preallocate();
+    }
+
+    // Moveable but not copyable, like wade::tracker. Moving takes the objects and the pool with its slab,
+    // and leaves rhs with neither, so rhs may still attach objects but make() returns nullptr until it is assigned another tracker.
+    fixed_tracker(fixed_tracker &&) = default;
+    fixed_tracker & operator=(fixed_tracker &&) = default;
+
+    ~fixed_tracker() = default;
+};
+
+template <typename Derived, typename Tracked_T, std::size_t Capacity, typename Dirty_T>
+constexpr typename fixed_tracker<Derived, Tracked_T, Capacity, Dirty_T>::size_type fixed_tracker<Derived, Tracked_T, Capacity, Dirty_T>::capacity;
+
+}
+
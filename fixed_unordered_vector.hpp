@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+
+namespace wade {
+
+// Unordered vector (see wade::unordered_vector) whose values are stored in an array of Capacity values inside the container,
+// so inserting and erasing never allocate and take constant time. Inserting into a full vector is not allowed,
+// so a tracker checks full() and reports that it cannot attach instead (see wade::fixed_tracker). For example:
+//   wade::tracker<Mytracker, MyClass, wade::fixed_unordered_vector<MyClass *, 64> >
+template <typename T, std::size_t Capacity>
+class fixed_unordered_vector
+{
+    static_assert(Capacity > 0, "Must have room for at least one value");
+
+    using array_type = std::array<T, Capacity>;
+
+public:
+
+    using value_type = T;
+    using size_type = typename array_type::size_type;
+    using difference_type = typename array_type::difference_type;
+    using reference = typename array_type::reference;
+    using const_reference = typename array_type::const_reference;
+    using iterator = typename array_type::const_iterator;
+    using const_iterator = typename array_type::const_iterator;
+
+    // Position of a value in the vector.
+    using hook_type = size_type;
+
+    fixed_unordered_vector() = default;
+
+    // Moving copies the values and leaves rhs empty, so the values are only in one container.
+    fixed_unordered_vector(fixed_unordered_vector const &) = default;
+    fixed_unordered_vector & operator=(fixed_unordered_vector const &) = default;
+    fixed_unordered_vector(fixed_unordered_vector && rhs)
+        : values_(rhs.values_)
+        , size_{rhs.size_}
+    {
+        rhs.clear();
+    }
+    fixed_unordered_vector & operator=(fixed_unordered_vector && rhs)
+    {
+        if (this != &rhs)
+        {
+            values_ = rhs.values_;
+            size_ = rhs.size_;
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    // Insert a value at the end and store its position in its hook.
+    template <typename Hook_Of>
+    void insert(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        assert(not full());
+        a_hook_of(a_value) = size_;
+        values_[size_++] = a_value;
+    }
+
+    // Erase a value by moving the last value into its position, which updates the moved value's hook.
+    template <typename Hook_Of>
+    void erase(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        size_type const index = a_hook_of(a_value);
+        assert(index < size_ and values_[index] == a_value);
+        if (index + 1 != size_)
+        {
+            values_[index] = values_[size_ - 1];
+            a_hook_of(values_[index]) = index;
+        }
+        values_[--size_] = value_type{};
+    }
+
+    // Erase a value by replacing it with a null value, which does not move any other values.
+    template <typename Hook_Of>
+    void erase_deferred(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        size_type const index = a_hook_of(a_value);
+        assert(index < size_ and values_[index] == a_value);
+        values_[index] = value_type{};
+    }
+
+    // Erase all null values, keeping the other values in order and updating their hooks.
+    template <typename Hook_Of>
+    void compact(Hook_Of const & a_hook_of)
+    {
+        size_type size = 0;
+        for (size_type i = 0; i != size_; ++i)
+        {
+            if (values_[i])
+            {
+                a_hook_of(values_[i]) = size;
+                values_[size++] = values_[i];
+            }
+        }
+        for (size_type i = size; i != size_; ++i)
+        {
+            values_[i] = value_type{};
+        }
+        size_ = size;
+    }
+
+    void clear() { values_.fill(value_type{}); size_ = 0; }
+
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.begin() + static_cast<difference_type>(size_); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    const_reference operator[](size_type a_index) const { assert(a_index < size_); return values_[a_index]; }
+    value_type const * data() const { return values_.data(); }
+
+    size_type size() const { return size_; }
+    static constexpr size_type capacity() { return Capacity; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == Capacity; }
+
+private:
+
+    array_type values_{};
+    size_type size_ = 0;
+};
+
+}
+
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+// Hash set of pointers stored in a single array with open addressing (linear probing), which finds values in constant time without allocating a node for each one.
+// Erasing moves following values of the same probe sequence back into the erased slot (backward-shift deletion),
+// so no tombstones are left and lookups never slow down after many erasures.
+// Pointers are hashed by address with Fibonacci hashing, and a null pointer marks an empty slot, so only non-null values may be inserted.
+// Found through wade::find() by its find() member, like std::set. For example:
+//   TRACKER_WITH_CONTAINER(Mytracker, MyClass, wade::flat_hash_set)
+template <typename T>
+class flat_hash_set
+{
+    using vector_type = std::vector<T>;
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type const &;
+    using const_reference = value_type const &;
+
+    // Forward iterator that skips empty slots.
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const *;
+        using reference = value_type const &;
+
+        const_iterator() = default;
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+
+        const_iterator & operator++() { ++slot_; skip(); return *this; }
+        const_iterator operator++(int) { const_iterator result{*this}; ++*this; return result; }
+
+        bool operator==(const_iterator const & rhs) const { return slot_ == rhs.slot_; }
+        bool operator!=(const_iterator const & rhs) const { return slot_ != rhs.slot_; }
+
+    private:
+
+        friend class flat_hash_set;
+
+        const_iterator(pointer a_slot, pointer an_end) : slot_{a_slot}, end_{an_end} { skip(); }
+
+        void skip() { while (slot_ != end_ and not *slot_) { ++slot_; } }
+
+        pointer slot_ = nullptr;
+        pointer end_ = nullptr;
+    };
+    using iterator = const_iterator;
+
+    // Maximum ratio of values to slots, as a fraction of 8, before the table grows.
+    // Note: linear probing needs some empty slots to keep probe sequences short.
+    static constexpr size_type max_load_eighths = 6;
+
+    flat_hash_set() = default;
+
+    // Moving leaves rhs empty with no table, so it may be reused.
+    flat_hash_set(flat_hash_set const &) = default;
+    flat_hash_set & operator=(flat_hash_set const &) = default;
+    flat_hash_set(flat_hash_set && rhs)
+        : slots_(std::move(rhs.slots_))
+        , size_{rhs.size_}
+        , shift_{rhs.shift_}
+    {
+        rhs.reset();
+    }
+    flat_hash_set & operator=(flat_hash_set && rhs)
+    {
+        if (this != &rhs)
+        {
+            slots_ = std::move(rhs.slots_);
+            size_ = rhs.size_;
+            shift_ = rhs.shift_;
+            rhs.reset();
+        }
+        return *this;
+    }
+
+    // Insert a value if not already in the set, growing the table if needed.
+    // The hint is ignored, but allows inserting like any other standard container.
+    std::pair<iterator, bool> insert(value_type const &);
+    iterator insert(const_iterator, value_type const & a_value) { return insert(a_value).first; }
+
+    // Erase a value by moving back the following values of its probe sequence.
+    // Unlike other containers, does not return the next iterator since a following value may have moved back into the erased slot.
+    void erase(const_iterator);
+    size_type erase(value_type const &);
+
+    // Find a value, or end() if not in the set.
+    const_iterator find(value_type const &) const;
+    size_type count(value_type const & a_value) const { return find(a_value) != end() ? 1 : 0; }
+
+    // Erase all values, keeping the table for reuse.
+    void clear() { std::fill(std::begin(slots_), std::end(slots_), value_type{}); size_ = 0; }
+
+    // Grow the table so that it holds a number of values without growing again.
+    void reserve(size_type);
+
+    const_iterator begin() const { return const_iterator{slots_.data(), slots_.data() + slots_.size()}; }
+    const_iterator end() const { return const_iterator{slots_.data() + slots_.size(), slots_.data() + slots_.size()}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_type size() const { return size_; }
+    size_type capacity() const { return slots_.size() * max_load_eighths / 8; }
+    bool empty() const { return size_ == 0; }
+
+private:
+
+    // Release the table, leaving the set as if default-constructed.
+    void reset() { slots_.clear(); slots_.shrink_to_fit(); size_ = 0; shift_ = 64; }
+
+    // Slot where a value's probe sequence starts.
+    size_type home_of(value_type const &) const;
+
+    // Move all values into a table with a number of slots, which must be a power of 2.
+    void rehash(size_type);
+
+    // Number of slots is 0 or a power of 2 (so wrapping around is a mask) and at least 8.
+    vector_type slots_{};
+    size_type size_ = 0;
+    unsigned shift_ = 64;
+};
+
+template <typename T>
+constexpr typename flat_hash_set<T>::size_type flat_hash_set<T>::max_load_eighths;
+
+template <typename T>
+std::pair<typename flat_hash_set<T>::iterator, bool>
+flat_hash_set<T>::
+insert(value_type const & a_value)
+{
+    assert(a_value);
+    if (size_ + 1 > capacity())
+    {
+        rehash(slots_.empty() ? 8 : slots_.size() * 2);
+    }
+
+    size_type const mask = slots_.size() - 1;
+    for (size_type i = home_of(a_value); ; i = (i + 1) & mask)
+    {
+        if (slots_[i] == a_value)
+        {
+            return {iterator{&slots_[i], slots_.data() + slots_.size()}, false};
+        }
+        if (not slots_[i])
+        {
+            slots_[i] = a_value;
+            ++size_;
+            return {iterator{&slots_[i], slots_.data() + slots_.size()}, true};
+        }
+    }
+}
+
+template <typename T>
+void
+flat_hash_set<T>::
+erase(const_iterator a_position)
+{
+    assert(a_position != end());
+    size_type const mask = slots_.size() - 1;
+    auto hole = static_cast<size_type>(a_position.slot_ - slots_.data());
+
+    // Move back each following value whose home is not between the hole and its slot (cyclically),
+    // since it could not be found past the hole otherwise. Stop at the first empty slot, which ends the probe sequence.
+    for (size_type i = (hole + 1) & mask; slots_[i]; i = (i + 1) & mask)
+    {
+        size_type const home = home_of(slots_[i]);
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            slots_[hole] = slots_[i];
+            hole = i;
+        }
+    }
+    slots_[hole] = value_type{};
+    --size_;
+}
+
+template <typename T>
+typename flat_hash_set<T>::size_type
+flat_hash_set<T>::
+erase(value_type const & a_value)
+{
+    auto && position = find(a_value);
+    if (position == end())
+    {
+        return 0;
+    }
+    erase(position);
+    return 1;
+}
+
+template <typename T>
+typename flat_hash_set<T>::const_iterator
+flat_hash_set<T>::
+find(value_type const & a_value) const
+{
+    if (slots_.empty() or not a_value)
+    {
+        return end();
+    }
+    size_type const mask = slots_.size() - 1;
+    for (size_type i = home_of(a_value); slots_[i]; i = (i + 1) & mask)
+    {
+        if (slots_[i] == a_value)
+        {
+            return const_iterator{&slots_[i], slots_.data() + slots_.size()};
+        }
+    }
+    return end();
+}
+
+template <typename T>
+void
+flat_hash_set<T>::
+reserve(size_type a_capacity)
+{
+    if (a_capacity <= capacity())
+    {
+        return;
+    }
+    size_type a_size = slots_.empty() ? 8 : slots_.size();
+    while (a_size * max_load_eighths / 8 < a_capacity)
+    {
+        a_size *= 2;
+    }
+    rehash(a_size);
+}
+
+template <typename T>
+typename flat_hash_set<T>::size_type
+flat_hash_set<T>::
+home_of(value_type const & a_value) const
+{
+    // Note: the high bits of the product are the best mixed, so they select the slot.
+    auto const address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&*a_value));
+    return static_cast<size_type>((address * UINT64_C(11400714819323198485)) >> shift_);
+}
+
+template <typename T>
+void
+flat_hash_set<T>::
+rehash(size_type a_size)
+{
+    assert(a_size >= 8 and (a_size & (a_size - 1)) == 0);
+    vector_type old_slots(a_size);
+    old_slots.swap(slots_);
+    shift_ = 64;
+    for (size_type i = a_size; i > 1; i /= 2)
+    {
+        --shift_;
+    }
+
+    size_type const mask = a_size - 1;
+    for (auto && a_value : old_slots)
+    {
+        if (a_value)
+        {
+            size_type i = home_of(a_value);
+            while (slots_[i])
+            {
+                i = (i + 1) & mask;
+            }
+            slots_[i] = a_value;
+        }
+    }
+}
+
+}
+
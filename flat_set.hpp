@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+// Set stored in a single sorted vector, which finds values by binary search and is iterated contiguously.
+// Inserted values are appended to an unsorted tail, which is sorted and merged into the rest once it is needed (i.e., by iterating,
+// or by finding a value while the tail is long), so inserting many values costs a single merge rather than shifting the vector for each one.
+// Erasing still moves the following values forward. Since the tail contains no previously inserted values, values must be unique
+// (which the objects of a tracker always are). Found through wade::find() by its find() member, like std::set. For example:
+//   TRACKER_WITH_CONTAINER(Mytracker, MyClass, wade::flat_set)
+// Values cannot be replaced without breaking their order, so detaching cannot be deferred with this container.
+template <typename T, typename Compare = std::less<T> >
+class flat_set
+{
+    using vector_type = std::vector<T>;
+
+public:
+
+    using value_type = T;
+    using size_type = typename vector_type::size_type;
+    using difference_type = typename vector_type::difference_type;
+    using reference = value_type const &;
+    using const_reference = value_type const &;
+    using iterator = value_type const *;
+    using const_iterator = value_type const *;
+
+    // Longest tail that find() searches linearly instead of merging it first.
+    static constexpr size_type max_tail_size = 16;
+
+    explicit flat_set(Compare a_compare = Compare{})
+        : compare_(std::move(a_compare))
+    {
+    }
+
+    // Moving leaves rhs empty.
+    flat_set(flat_set const &) = default;
+    flat_set & operator=(flat_set const &) = default;
+    flat_set(flat_set && rhs)
+        : compare_(std::move(rhs.compare_))
+        , values_(std::move(rhs.values_))
+        , sorted_size_{rhs.sorted_size_}
+    {
+        rhs.clear();
+    }
+    flat_set & operator=(flat_set && rhs)
+    {
+        compare_ = std::move(rhs.compare_);
+        values_ = std::move(rhs.values_);
+        sorted_size_ = rhs.sorted_size_;
+        rhs.clear();
+        return *this;
+    }
+
+    // Append a value to the tail, which must not already be in the set.
+    // The hint is ignored, but allows inserting like any other standard container. Returns nothing since the value's position is only known once merged.
+    void insert(value_type const & a_value) { values_.push_back(a_value); }
+    void insert(const_iterator, value_type const & a_value) { insert(a_value); }
+
+    // Erase a value, moving the following values forward. Returns the position following the erased value.
+    iterator erase(const_iterator);
+    size_type erase(value_type const &);
+
+    // Find a value, or end() if not in the set.
+    const_iterator find(value_type const &) const;
+    size_type count(value_type const & a_value) const { return find(a_value) != end() ? 1 : 0; }
+
+    void clear() { values_.clear(); sorted_size_ = 0; }
+    void reserve(size_type a_capacity) { values_.reserve(a_capacity); }
+
+    // Iterating merges the tail first, so values are visited in order. The end is not moved by merging.
+    const_iterator begin() const { merge(); return values_.data(); }
+    const_iterator end() const { return values_.data() + values_.size(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    const_reference operator[](size_type a_index) const { return begin()[a_index]; }
+    value_type const * data() const { return begin(); }
+
+    size_type size() const { return values_.size(); }
+    size_type capacity() const { return values_.capacity(); }
+    bool empty() const { return values_.empty(); }
+
+private:
+
+    // Sort the tail and merge it into the sorted values.
+    void merge() const;
+
+    Compare compare_;
+
+    // Sorted values followed by the unsorted tail.
+    // Note: mutable since merging does not change which values are in the set.
+    mutable vector_type values_{};
+    mutable size_type sorted_size_ = 0;
+};
+
+template <typename T, typename Compare>
+constexpr typename flat_set<T, Compare>::size_type flat_set<T, Compare>::max_tail_size;
+
+template <typename T, typename Compare>
+typename flat_set<T, Compare>::iterator
+flat_set<T, Compare>::
+erase(const_iterator a_position)
+{
+    assert(end() != a_position);
+    auto const index = static_cast<size_type>(a_position - values_.data());
+    assert(index < values_.size());
+    if (index < sorted_size_)
+    {
+        --sorted_size_;
+    }
+    values_.erase(std::begin(values_) + static_cast<difference_type>(index));
+    return values_.data() + index;
+}
+
+template <typename T, typename Compare>
+typename flat_set<T, Compare>::size_type
+flat_set<T, Compare>::
+erase(value_type const & a_value)
+{
+    auto && position = find(a_value);
+    if (position == end())
+    {
+        return 0;
+    }
+    erase(position);
+    return 1;
+}
+
+template <typename T, typename Compare>
+typename flat_set<T, Compare>::const_iterator
+flat_set<T, Compare>::
+find(value_type const & a_value) const
+{
+    // Search a short tail linearly, so alternately inserting and erasing does not merge each time.
+    if (values_.size() - sorted_size_ > max_tail_size)
+    {
+        merge();
+    }
+    value_type const * const first = values_.data();
+    value_type const * const sorted_end = first + sorted_size_;
+    value_type const * const found = std::lower_bound(first, sorted_end, a_value, compare_);
+    if (found != sorted_end and not compare_(a_value, *found))
+    {
+        return found;
+    }
+    for (value_type const * tail = sorted_end; tail != end(); ++tail)
+    {
+        if (not compare_(a_value, *tail) and not compare_(*tail, a_value))
+        {
+            return tail;
+        }
+    }
+    return end();
+}
+
+template <typename T, typename Compare>
+void
+flat_set<T, Compare>::
+merge() const
+{
+    if (sorted_size_ != values_.size())
+    {
+        auto const middle = std::begin(values_) + static_cast<difference_type>(sorted_size_);
+        std::sort(middle, std::end(values_), compare_);
+        std::inplace_merge(std::begin(values_), middle, std::end(values_), compare_);
+        sorted_size_ = values_.size();
+        assert(std::adjacent_find(std::begin(values_), std::end(values_), [this](value_type const & a_value, value_type const & a_next) { return not compare_(a_value, a_next); }) == std::end(values_));
+    }
+}
+
+}
+
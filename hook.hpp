@@ -0,0 +1,191 @@
+#pragma once
+
+#include "find.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+
+
+namespace wade {
+
+// Hook used by containers that do not store any data in their tracked objects (i.e., std::vector, std::set).
+struct no_hook
+{
+};
+
+}
+
+namespace {
+
+template <typename...>
+using void_t = void;
+
+template <typename Container, typename = void>
+struct hook_type_impl
+{
+    using type = wade::no_hook;
+};
+
+template <typename Container>
+struct hook_type_impl<Container, void_t<typename Container::hook_type> >
+{
+    using type = typename Container::hook_type;
+};
+
+}
+
+namespace wade {
+
+// Per-object data that a container stores inside each tracked object, such as the object's position in the container.
+// A container declares its hook with a nested hook_type and must then define these methods:
+//   template <typename Hook_Of> void insert(value_type, Hook_Of); // Insert a value and initialize its hook.
+//   template <typename Hook_Of> void erase(value_type, Hook_Of); // Erase a value and update the hooks of any moved values.
+// where Hook_Of is a callable that maps any value in the container to a reference to its hook.
+// To allow detaching to be deferred (see tracker::defer_detach()), a container with a hook must also define:
+//   template <typename Hook_Of> void erase_deferred(value_type, Hook_Of); // Replace a value with a null value without moving any others.
+//   template <typename Hook_Of> void compact(Hook_Of); // Erase all null values and update the hooks of any moved values.
+// Containers without a hook_type use no_hook and are modified with the standard insert() and erase() methods,
+// and can only defer erasing if their iterators allow assigning a null value in place (i.e., std::vector but not std::set).
+template <typename Container>
+using hook_type = typename hook_type_impl<Container>::type;
+
+template <typename Container>
+using has_hook = std::integral_constant<bool, not std::is_same<hook_type<Container>, no_hook>::value>;
+
+// Storage for a hook inside a tracked object.
+// An empty hook takes no space when used as a base class (empty base optimization).
+// Member names are prefixed to avoid colliding with the names of the tracked type.
+template <typename Hook_T, bool = std::is_empty<Hook_T>::value>
+class hook_holder
+{
+public:
+
+    Hook_T & tracker_hook() { return tracker_hook_; }
+    Hook_T const & tracker_hook() const { return tracker_hook_; }
+
+protected:
+
+    // Hooks are never copied or moved with their objects since they describe a position in a specific container.
+    hook_holder() = default;
+    hook_holder(hook_holder const &) : tracker_hook_{} {}
+    hook_holder & operator=(hook_holder const &) { return *this; }
+    ~hook_holder() = default;
+
+private:
+
+    Hook_T tracker_hook_{};
+};
+
+template <typename Hook_T>
+class hook_holder<Hook_T, true>
+    : private Hook_T
+{
+public:
+
+    Hook_T & tracker_hook() { return *this; }
+    Hook_T const & tracker_hook() const { return *this; }
+
+protected:
+
+    hook_holder() = default;
+    hook_holder(hook_holder const &) {}
+    hook_holder & operator=(hook_holder const &) { return *this; }
+    ~hook_holder() = default;
+};
+
+}
+
+namespace {
+
+template <class Container, class T, class Hook_Of>
+void insert_impl(Container & a_container, T const & a_value, Hook_Of const & a_hook_of, std::true_type)
+{
+    a_container.insert(a_value, a_hook_of);
+}
+
+template <class Container, class T, class Hook_Of>
+void insert_impl(Container & a_container, T const & a_value, Hook_Of const &, std::false_type)
+{
+    // Use insert() since it is used by all container types and will insert at the end for a vector.
+    a_container.insert(std::end(a_container), a_value);
+}
+
+template <class Container, class T, class Hook_Of>
+void erase_impl(Container & a_container, T const & a_value, Hook_Of const & a_hook_of, std::true_type)
+{
+    a_container.erase(a_value, a_hook_of);
+}
+
+template <class Container, class T, class Hook_Of>
+void erase_impl(Container & a_container, T const & a_value, Hook_Of const &, std::false_type)
+{
+    auto iter = wade::find(a_container, a_value);
+    assert(iter != std::end(a_container));
+    a_container.erase(iter);
+}
+
+template <class Container, class T, class Hook_Of>
+void erase_deferred_impl(Container & a_container, T const & a_value, Hook_Of const & a_hook_of, std::true_type)
+{
+    a_container.erase_deferred(a_value, a_hook_of);
+}
+
+template <class Container, class T, class Hook_Of>
+void erase_deferred_impl(Container & a_container, T const & a_value, Hook_Of const &, std::false_type)
+{
+    auto iter = wade::find(a_container, a_value);
+    assert(iter != std::end(a_container));
+    *iter = typename Container::value_type{};
+}
+
+template <class Container, class Hook_Of>
+void compact_impl(Container & a_container, Hook_Of const & a_hook_of, std::true_type)
+{
+    a_container.compact(a_hook_of);
+}
+
+template <class Container, class Hook_Of>
+void compact_impl(Container & a_container, Hook_Of const &, std::false_type)
+{
+    a_container.erase(std::remove(std::begin(a_container), std::end(a_container), typename Container::value_type{}), std::end(a_container));
+}
+
+}
+
+namespace wade {
+
+// Insert a value into a container.
+// Containers with a hook are given the hook accessor so they can record where the value was inserted.
+template <class Container, class T, class Hook_Of>
+void insert(Container & a_container, T const & a_value, Hook_Of const & a_hook_of)
+{
+    insert_impl(a_container, a_value, a_hook_of, has_hook<Container>{});
+}
+
+// Erase a value that is in a container.
+// Containers with a hook locate the value through its hook, while others search for it with wade::find().
+template <class Container, class T, class Hook_Of>
+void erase(Container & a_container, T const & a_value, Hook_Of const & a_hook_of)
+{
+    erase_impl(a_container, a_value, a_hook_of, has_hook<Container>{});
+}
+
+// Erase a value that is in a container by replacing it with a null value, which keeps all other values in place.
+// Null values are erased later by compact().
+template <class Container, class T, class Hook_Of>
+void erase_deferred(Container & a_container, T const & a_value, Hook_Of const & a_hook_of)
+{
+    erase_deferred_impl(a_container, a_value, a_hook_of, has_hook<Container>{});
+}
+
+// Erase all null values from a container in a single pass.
+template <class Container, class Hook_Of>
+void compact(Container & a_container, Hook_Of const & a_hook_of)
+{
+    compact_impl(a_container, a_hook_of, has_hook<Container>{});
+}
+
+}
+
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+
+namespace wade {
+
+// Doubly-linked list whose links are stored in the hooks of its values, so inserting and erasing are constant-time splices
+// that never allocate (and there is nothing to reserve or grow). Values are iterated in order of insertion.
+// Iteration follows a pointer for each value, so prefer a vector if iterating is more frequent than attaching and detaching.
+// Since erasing unlinks a value immediately, detaching cannot be deferred (see tracker::defer_detach()). For example:
+//   TRACKER_WITH_CONTAINER(Mytracker, MyClass, wade::intrusive_list)
+template <typename T>
+class intrusive_list
+{
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type const &;
+    using const_reference = value_type const &;
+
+    // Links to the hooks of the neighboring values, and the value itself, so the list can be iterated without knowing how to find a value's hook.
+    struct hook_type
+    {
+        hook_type * prev = nullptr;
+        hook_type * next = nullptr;
+        value_type value{};
+    };
+
+    // Forward iterator over values in order of insertion.
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const *;
+        using reference = value_type const &;
+
+        const_iterator() = default;
+
+        reference operator*() const { return node_->value; }
+        pointer operator->() const { return &node_->value; }
+
+        const_iterator & operator++() { node_ = node_->next; return *this; }
+        const_iterator operator++(int) { const_iterator result{*this}; ++*this; return result; }
+
+        bool operator==(const_iterator const & rhs) const { return node_ == rhs.node_; }
+        bool operator!=(const_iterator const & rhs) const { return node_ != rhs.node_; }
+
+    private:
+
+        friend class intrusive_list;
+
+        explicit const_iterator(hook_type const * a_node) : node_{a_node} {}
+
+        hook_type const * node_ = nullptr;
+    };
+    using iterator = const_iterator;
+
+    // Moveable but not copyable, since hooks can only link values into one list.
+    intrusive_list() = default;
+    intrusive_list(intrusive_list const &) = delete;
+    intrusive_list & operator=(intrusive_list const &) = delete;
+    intrusive_list(intrusive_list && rhs)
+        : head_{rhs.head_}
+        , tail_{rhs.tail_}
+        , size_{rhs.size_}
+    {
+        rhs.clear();
+    }
+    intrusive_list & operator=(intrusive_list && rhs)
+    {
+        if (this != &rhs)
+        {
+            head_ = rhs.head_;
+            tail_ = rhs.tail_;
+            size_ = rhs.size_;
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    // Link a value at the end.
+    template <typename Hook_Of>
+    void insert(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        hook_type & a_hook = a_hook_of(a_value);
+        a_hook.prev = tail_;
+        a_hook.next = nullptr;
+        a_hook.value = a_value;
+        (tail_ ? tail_->next : head_) = &a_hook;
+        tail_ = &a_hook;
+        ++size_;
+    }
+
+    // Unlink a value from its neighbors.
+    template <typename Hook_Of>
+    void erase(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        hook_type & a_hook = a_hook_of(a_value);
+        assert(a_hook.value == a_value and size_ != 0);
+        (a_hook.prev ? a_hook.prev->next : head_) = a_hook.next;
+        (a_hook.next ? a_hook.next->prev : tail_) = a_hook.prev;
+        a_hook = hook_type{};
+        --size_;
+    }
+
+    // Forget all values, whose hooks are left as they are.
+    void clear()
+    {
+        head_ = nullptr;
+        tail_ = nullptr;
+        size_ = 0;
+    }
+
+    const_iterator begin() const { return const_iterator{head_}; }
+    const_iterator end() const { return const_iterator{}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+
+    hook_type * head_ = nullptr;
+    hook_type * tail_ = nullptr;
+    size_type size_ = 0;
+};
+
+}
+
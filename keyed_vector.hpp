@@ -0,0 +1,140 @@
+#pragma once
+
+#include "unordered_vector.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+
+namespace {
+
+// Type of the key that a function object gives for the object that a value points to.
+template <typename T, typename Key_Of>
+using key_of_t = typename std::decay<decltype(std::declval<Key_Of const &>()(*std::declval<T>()))>::type;
+
+}
+
+namespace wade {
+
+// Unordered vector that also indexes its values by a key, so a tracker can find objects by key in constant time with tracker::find_by_key().
+// The key of each value is given by Key_Of, a function object that takes a reference to a tracked object, such as:
+//   struct id_of { int operator()(MyClass const & an_object) const { return an_object.id; } };
+//   wade::tracker<Mytracker, MyClass, wade::keyed_vector<MyClass *, id_of> >
+// The index is updated by insert() and erase(), so it is maintained when objects are attached and detached without any work by the derived tracker.
+// An object's key must not change while it is attached. Keys need not be unique (i.e., copies of an object are attached with the same key),
+// in which case any of the objects with the key is found.
+template <typename T, typename Key_Of, typename Hash = std::hash<key_of_t<T, Key_Of> > >
+class keyed_vector
+{
+    using vector_type = unordered_vector<T>;
+
+public:
+
+    using value_type = T;
+    using key_type = key_of_t<T, Key_Of>;
+    using size_type = typename vector_type::size_type;
+    using difference_type = typename vector_type::difference_type;
+    using reference = typename vector_type::reference;
+    using const_reference = typename vector_type::const_reference;
+    using iterator = typename vector_type::iterator;
+    using const_iterator = typename vector_type::const_iterator;
+
+    // Position of a value in the vector.
+    using hook_type = typename vector_type::hook_type;
+
+    explicit keyed_vector(Key_Of a_key_of = Key_Of{})
+        : key_of_(std::move(a_key_of))
+    {
+    }
+
+    // Insert a value and index it by its key.
+    // If either throws (i.e., allocating), neither has the value, so the index never refers to a value that was not inserted.
+    template <typename Hook_Of>
+    void insert(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        values_.insert(a_value, a_hook_of);
+        try
+        {
+            index_.emplace(key_of_(*a_value), a_value);
+        }
+        catch (...)
+        {
+            values_.erase(a_value, a_hook_of);
+            throw;
+        }
+    }
+
+    // Erase a value and its key, moving the last value into its position.
+    template <typename Hook_Of>
+    void erase(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        unindex(a_value);
+        values_.erase(a_value, a_hook_of);
+    }
+
+    // Erase a value's key now, and replace the value with a null value that is erased by compact().
+    template <typename Hook_Of>
+    void erase_deferred(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        unindex(a_value);
+        values_.erase_deferred(a_value, a_hook_of);
+    }
+
+    // Erase all null values. The index is unchanged since it refers to values rather than their positions.
+    template <typename Hook_Of>
+    void compact(Hook_Of const & a_hook_of)
+    {
+        values_.compact(a_hook_of);
+    }
+
+    // Find a value by key. Returns a null value if no value has the key.
+    value_type find_by_key(key_type const & a_key) const
+    {
+        auto && found = index_.find(a_key);
+        return found != std::end(index_) ? found->second : value_type{};
+    }
+
+    void clear() { values_.clear(); index_.clear(); }
+    void reserve(size_type a_capacity) { values_.reserve(a_capacity); index_.reserve(a_capacity); }
+
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+    const_iterator cbegin() const { return values_.cbegin(); }
+    const_iterator cend() const { return values_.cend(); }
+
+    const_reference operator[](size_type a_index) const { return values_[a_index]; }
+    value_type const * data() const { return values_.data(); }
+
+    size_type size() const { return values_.size(); }
+    size_type capacity() const { return values_.capacity(); }
+    bool empty() const { return values_.empty(); }
+
+private:
+
+    // Erase the index entry of a specific value, which is one of the values with its key.
+    void unindex(value_type const & a_value)
+    {
+        auto && range = index_.equal_range(key_of_(*a_value));
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second == a_value)
+            {
+                index_.erase(iter);
+                return;
+            }
+        }
+        assert(false);
+    }
+
+    Key_Of key_of_;
+    vector_type values_{};
+    std::unordered_multimap<key_type, value_type, Hash> index_{};
+};
+
+}
+
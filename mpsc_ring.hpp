@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+
+namespace wade {
+
+// Bounded, lock-free queue for any number of producer threads and a single consumer thread.
+// Values are stored in a ring of Capacity cells, each with a sequence number that tells producers and the consumer
+// whether the cell is free for the current lap around the ring or holds a value for it, so neither side ever takes a lock.
+// Producers claim cells with compare-and-swap, and the consumer takes values in the order their cells were claimed.
+// Values must be default-constructible and moveable.
+template <typename T, std::size_t Capacity = 1024>
+class mpsc_ring
+{
+    static_assert(Capacity > 1 and (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    mpsc_ring()
+        : cells_{new cell[Capacity]}
+    {
+        for (size_type i = 0; i != Capacity; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpsc_ring(mpsc_ring const &) = delete;
+    mpsc_ring & operator=(mpsc_ring const &) = delete;
+
+    // Add a value if there is room. Thread-safe for any number of producers.
+    // Returns true if successful and false if full.
+    bool try_push(value_type a_value)
+    {
+        size_type position = tail_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell & a_cell = cells_[position & (Capacity - 1)];
+            size_type const sequence = a_cell.sequence.load(std::memory_order_acquire);
+            auto const lap = static_cast<std::ptrdiff_t>(sequence - position);
+            if (lap == 0)
+            {
+                // Cell is free for this lap, so claim it.
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    a_cell.value = std::move(a_value);
+                    a_cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lap < 0)
+            {
+                // Cell still holds a value from the previous lap.
+                return false;
+            }
+            else
+            {
+                // Another producer claimed the cell first.
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Add a value, yielding until there is room, so no value is ever dropped.
+    // The consumer must keep draining on another thread, or producers wait forever, so never call this on the consumer's thread
+    // (use try_push() there instead, which never waits).
+    void push(value_type a_value)
+    {
+        while (not try_push(a_value))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Take the oldest value if there is one. Must only be called by the consumer.
+    // Returns true if successful and false if empty.
+    bool try_pop(value_type & a_value)
+    {
+        cell & a_cell = cells_[head_ & (Capacity - 1)];
+        if (a_cell.sequence.load(std::memory_order_acquire) != head_ + 1)
+        {
+            return false;
+        }
+        a_value = std::move(a_cell.value);
+
+        // Free the cell for the next lap.
+        a_cell.sequence.store(head_ + Capacity, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    // Take up to a number of values in order, calling a function with each one. Must only be called by the consumer.
+    // Returns the number of values taken.
+    template <typename Function>
+    size_type drain(Function && a_function, size_type a_max = Capacity)
+    {
+        size_type count = 0;
+        value_type a_value{};
+        while (count != a_max and try_pop(a_value))
+        {
+            a_function(std::move(a_value));
+            ++count;
+        }
+        return count;
+    }
+
+    // Whether there are no values to take. Only exact for the consumer while no producer is pushing.
+    bool empty() const { return cells_[head_ & (Capacity - 1)].sequence.load(std::memory_order_acquire) != head_ + 1; }
+
+    static constexpr size_type capacity() { return Capacity; }
+
+private:
+
+    struct cell
+    {
+        std::atomic<size_type> sequence{0};
+        value_type value{};
+    };
+
+    std::unique_ptr<cell[]> cells_;
+
+    // Note: padding keeps the consumer's position and the producers' position in separate cache lines.
+    size_type head_ = 0;
+    char padding_[64];
+    std::atomic<size_type> tail_{0};
+};
+
+}
+
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+// Pool of equally sized blocks of memory, which are allocated together in slabs.
+// Freed blocks are kept on an intrusive free list and reused before any new slab is allocated,
+// so allocating and deallocating are constant time and blocks allocated in sequence are adjacent in memory.
+// The block size is set by the first allocation, and all later allocations must be no larger.
+// Memory is only returned when the pool is destroyed, which does not run any destructors.
+class object_pool
+{
+public:
+
+    using size_type = std::size_t;
+
+    // Construct with the number of blocks to allocate in each slab.
+    explicit object_pool(size_type a_slab_size = 64)
+        : slab_size_{a_slab_size}
+    {
+        assert(slab_size_ > 0);
+    }
+
+    object_pool(object_pool const &) = delete;
+    object_pool & operator=(object_pool const &) = delete;
+
+    // Get uninitialized memory for an object of the given size, which is aligned for any fundamental type.
+    void * allocate(size_type a_size)
+    {
+        allocate_units(a_size);
+
+        if (not free_)
+        {
+            grow();
+        }
+        block * a_block = free_;
+        free_ = free_->next;
+        ++size_;
+        return a_block;
+    }
+
+    // Set the size of blocks, and allocate a slab now if there is none, so the next slab_size() allocations do not allocate memory.
+    void preallocate(size_type a_size)
+    {
+        allocate_units(a_size);
+        if (slabs_.empty())
+        {
+            grow();
+        }
+    }
+
+    // Return memory from allocate() to the pool.
+    void deallocate(void * a_memory)
+    {
+        assert(a_memory and size_ > 0);
+        block * a_block = static_cast<block *>(a_memory);
+        a_block->next = free_;
+        free_ = a_block;
+        --size_;
+    }
+
+    // Size in bytes of each block, or 0 if nothing has been allocated.
+    size_type block_size() const { return block_units_ * sizeof(block); }
+
+    // Number of blocks in each slab.
+    size_type slab_size() const { return slab_size_; }
+
+    // Number of blocks currently allocated.
+    size_type size() const { return size_; }
+
+    // Number of blocks in all slabs.
+    size_type capacity() const { return slabs_.size() * slab_size_; }
+
+private:
+
+    // Unit of memory with the strictest fundamental alignment, which links to the next free block while unused.
+    union block
+    {
+        block * next;
+        std::max_align_t alignment;
+    };
+
+    // Set the number of units in each block on the first allocation, and check that later allocations fit.
+    void allocate_units(size_type a_size)
+    {
+        if (block_units_ == 0)
+        {
+            block_units_ = (a_size + sizeof(block) - 1) / sizeof(block);
+            block_units_ = block_units_ ? block_units_ : 1;
+        }
+        assert(a_size <= block_size());
+    }
+
+    // Allocate a slab and put its blocks on the free list in address order.
+    void grow()
+    {
+        std::unique_ptr<block[]> slab{new block[slab_size_ * block_units_]};
+        for (size_type i = slab_size_; i-- > 0; )
+        {
+            block * a_block = slab.get() + i * block_units_;
+            a_block->next = free_;
+            free_ = a_block;
+        }
+        slabs_.push_back(std::move(slab));
+    }
+
+    std::vector<std::unique_ptr<block[]> > slabs_{};
+    block * free_ = nullptr;
+    size_type slab_size_ = 0;
+    size_type block_units_ = 0;
+    size_type size_ = 0;
+};
+
+// Object pool with a count of its users, for sharing between allocators.
+struct shared_object_pool
+{
+    explicit shared_object_pool(object_pool::size_type a_slab_size)
+        : pool{a_slab_size}
+    {
+    }
+
+    object_pool pool;
+    std::size_t references = 1;
+};
+
+// Allocator that allocates single objects from a shared object_pool.
+// Copies (including rebound copies) share the same pool, which lives until the last copy is destroyed.
+// Since a tracker's made objects hold a copy in their deleter, the pool outlives both the tracker and all of its objects:
+//   struct Mytracker : wade::tracker<Mytracker, MyClass, std::vector<MyClass *>, wade::pool_allocator<MyClass> > { ... };
+// Like the tracker, copies of the allocator must not be used concurrently from multiple threads.
+template <typename T, std::size_t Slab_Size = 64>
+class pool_allocator
+{
+    template <typename, std::size_t>
+    friend class pool_allocator;
+
+public:
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = pool_allocator<U, Slab_Size>;
+    };
+
+    pool_allocator()
+        : shared_{new shared_object_pool{Slab_Size}}
+    {
+    }
+
+    pool_allocator(pool_allocator const & rhs)
+        : shared_{rhs.shared_}
+    {
+        ++shared_->references;
+    }
+
+    template <typename U>
+    pool_allocator(pool_allocator<U, Slab_Size> const & rhs)
+        : shared_{rhs.shared_}
+    {
+        ++shared_->references;
+    }
+
+    pool_allocator & operator=(pool_allocator rhs)
+    {
+        std::swap(shared_, rhs.shared_);
+        return *this;
+    }
+
+    ~pool_allocator()
+    {
+        if (--shared_->references == 0)
+        {
+            delete shared_;
+        }
+    }
+
+    T * allocate(std::size_t a_count)
+    {
+        assert(a_count == 1);
+        static_assert(alignof(T) <= alignof(std::max_align_t), "pool_allocator does not support over-aligned types");
+        return static_cast<T *>(shared_->pool.allocate(sizeof(T)));
+    }
+
+    void deallocate(T * a_value, std::size_t a_count)
+    {
+        assert(a_count == 1);
+        shared_->pool.deallocate(a_value);
+    }
+
+    // Get the pool shared by this allocator.
+    object_pool const & pool() const { return shared_->pool; }
+
+    template <typename U>
+    bool operator==(pool_allocator<U, Slab_Size> const & rhs) const { return shared_ == rhs.shared_; }
+    template <typename U>
+    bool operator!=(pool_allocator<U, Slab_Size> const & rhs) const { return not (*this == rhs); }
+
+private:
+
+    shared_object_pool * shared_ = nullptr;
+};
+
+// Allocator that allocates single objects from a shared object_pool with a single slab of Capacity blocks, and never allocates more.
+// The slab is allocated by preallocate() (which wade::fixed_tracker calls when constructed) or otherwise by the first allocation,
+// so allocating and deallocating never allocate memory after that. Use full() to check for room before allocating,
+// since allocating from a full pool throws std::bad_alloc. Copies share the same pool, like pool_allocator.
+// A default-constructed allocator has no pool and is always full, so an empty trackable_ptr (whose deleter holds an allocator) allocates nothing.
+// Get an allocator with a pool from make_pool(), and give it to a tracker's constructor (as wade::fixed_tracker does).
+template <typename T, std::size_t Capacity>
+class fixed_allocator
+{
+    static_assert(Capacity > 0, "Must have room for at least one object");
+
+    template <typename, std::size_t>
+    friend class fixed_allocator;
+
+public:
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = fixed_allocator<U, Capacity>;
+    };
+
+    static constexpr std::size_t capacity = Capacity;
+
+    fixed_allocator() = default;
+
+    // Make an allocator with a new pool.
+    static fixed_allocator make_pool()
+    {
+        fixed_allocator an_allocator{};
+        an_allocator.shared_ = new shared_object_pool{Capacity};
+        return an_allocator;
+    }
+
+    fixed_allocator(fixed_allocator const & rhs)
+        : shared_{rhs.shared_}
+    {
+        if (shared_)
+        {
+            ++shared_->references;
+        }
+    }
+
+    template <typename U>
+    fixed_allocator(fixed_allocator<U, Capacity> const & rhs)
+        : shared_{rhs.shared_}
+    {
+        if (shared_)
+        {
+            ++shared_->references;
+        }
+    }
+
+    // Moving takes the pool and leaves rhs without one, which is always full, so a moved-from tracker does not make objects from the same pool.
+    fixed_allocator(fixed_allocator && rhs)
+        : shared_{rhs.shared_}
+    {
+        rhs.shared_ = nullptr;
+    }
+
+    fixed_allocator & operator=(fixed_allocator rhs)
+    {
+        std::swap(shared_, rhs.shared_);
+        return *this;
+    }
+
+    ~fixed_allocator()
+    {
+        if (shared_ and --shared_->references == 0)
+        {
+            delete shared_;
+        }
+    }
+
+    T * allocate(std::size_t a_count)
+    {
+        assert(a_count == 1);
+        static_assert(alignof(T) <= alignof(std::max_align_t), "fixed_allocator does not support over-aligned types");
+        if (full())
+        {
+            throw std::bad_alloc{};
+        }
+        return static_cast<T *>(shared_->pool.allocate(sizeof(T)));
+    }
+
+    void deallocate(T * a_value, std::size_t a_count)
+    {
+        assert(a_count == 1);
+        shared_->pool.deallocate(a_value);
+    }
+
+    // Allocate the pool's slab for objects of type T now. Does nothing without a pool.
+    void preallocate()
+    {
+        if (shared_)
+        {
+            shared_->pool.preallocate(sizeof(T));
+        }
+    }
+
+    // Whether all Capacity objects are allocated, or there is no pool.
+    bool full() const { return not shared_ or shared_->pool.size() == Capacity; }
+
+    // Whether this allocator has a pool (i.e., was made by make_pool() and has not been moved from).
+    bool has_pool() const { return shared_ != nullptr; }
+
+    // Get the pool shared by this allocator, which must have one.
+    object_pool const & pool() const { assert(shared_); return shared_->pool; }
+
+    template <typename U>
+    bool operator==(fixed_allocator<U, Capacity> const & rhs) const { return shared_ == rhs.shared_; }
+    template <typename U>
+    bool operator!=(fixed_allocator<U, Capacity> const & rhs) const { return not (*this == rhs); }
+
+private:
+
+    shared_object_pool * shared_ = nullptr;
+};
+
+template <typename T, std::size_t Capacity>
+constexpr std::size_t fixed_allocator<T, Capacity>::capacity;
+
+}
+
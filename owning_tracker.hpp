@@ -0,0 +1,323 @@
+#pragma once
+
+#include "static_dispatch.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+// Aliases for long template names (not part of interface and will be undefined).
+#define OWNING_TRACKER_TEMPLATE_DECL template <typename Derived, typename Tracked_T, std::size_t Chunk_Size = 256>
+#define OWNING_TRACKER_TEMPLATE template <typename Derived, typename Tracked_T, std::size_t Chunk_Size>
+#define OWNING_TRACKER_TYPE owning_tracker<Derived, Tracked_T, Chunk_Size>
+
+// Factory that owns and tracks made objects, which it stores in place in chunks of Chunk_Size objects.
+// Unlike wade::tracker, objects are plain Tracked_T objects without a pointer to their tracker, made objects are
+// returned by reference, and objects are deleted by destroy() instead of by their owner.
+// Objects never move, so references stay valid until they are destroyed, and the memory of destroyed objects is reused by later objects.
+// Iterating with for_each() visits objects in memory order without dereferencing a pointer for each one
+// (though not in order of making, since memory is reused).
+//
+// Derive from this class and pass the derived class as the first template parameter (CRTP / static polymorphism).
+// The derived class may define any of these methods:
+//   void did_make(Tracked_T &); // Called by make() after constructing an object.
+//   void did_detach(Tracked_T &); // Called by destroy() before destroying an object.
+OWNING_TRACKER_TEMPLATE_DECL
+class owning_tracker
+{
+    static_assert(Chunk_Size > 0 and Chunk_Size % 64 == 0, "Chunk_Size must be a multiple of 64");
+    static_assert(alignof(Tracked_T) <= alignof(std::max_align_t), "owning_tracker does not support over-aligned types");
+
+public:
+
+    using tracked_type = Tracked_T;
+    using size_type = std::size_t;
+
+    static constexpr size_type chunk_size = Chunk_Size;
+
+    // Moveable but not copyable.
+    // Moving is cheap since objects stay in their chunks.
+    owning_tracker() = default;
+    owning_tracker(owning_tracker const &) = delete;
+    owning_tracker & operator=(owning_tracker const &) = delete;
+    owning_tracker(owning_tracker &&);
+    owning_tracker & operator=(owning_tracker &&);
+
+    // Make an object with the given arguments in the first free place.
+    // Calls did_make() after constructing.
+    template <typename ...Args>
+    tracked_type & make(Args && ...);
+
+    // Destroy an object made by this tracker, whose memory is reused by later objects.
+    // Calls did_detach() before destroying.
+    void destroy(tracked_type &);
+
+    // Destroy all objects in a single pass and free all chunks.
+    void destroy_all();
+
+    // Whether an object was made by this tracker and not yet destroyed.
+    bool is_attached(tracked_type const &) const;
+
+    // Call a function with a reference to each object in memory order.
+    // The function may make objects (which may or may not be visited, though no object is visited twice), but must only destroy the object it is called with.
+    template <typename Function>
+    void for_each(Function &&);
+
+    // Number of objects.
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Number of objects that fit in all chunks.
+    size_type capacity() const { return chunks_.size() * Chunk_Size; }
+
+protected:
+
+    // Destructor destroys all objects.
+    // Protected destructor since should not have a tracker base class pointer to a derived class instance.
+    ~owning_tracker();
+
+private:
+
+    // Memory for an object, which holds the next free slot while unused.
+    union slot
+    {
+        slot() {}
+        ~slot() {}
+
+        tracked_type value;
+        slot * next;
+    };
+
+    // Objects in memory order, with a bit for each slot that holds an object.
+    struct chunk
+    {
+        static constexpr size_type word_count = Chunk_Size / 64;
+
+        slot slots[Chunk_Size];
+        std::uint64_t occupied[word_count] = {};
+
+        bool is_occupied(size_type a_index) const { return (occupied[a_index / 64] >> (a_index % 64)) & 1; }
+        void set_occupied(size_type a_index, bool a_occupied)
+        {
+            std::uint64_t const bit = std::uint64_t{1} << (a_index % 64);
+            occupied[a_index / 64] = a_occupied ? (occupied[a_index / 64] | bit) : (occupied[a_index / 64] & ~bit);
+        }
+    };
+
+    // Find the chunk and index of a slot by address. Returns a null chunk if not in any chunk.
+    std::pair<chunk *, size_type> locate(void const *) const;
+
+    // Allocate a chunk and put its slots on the free list in address order.
+    void grow();
+
+    // Call the derived class's methods only if defined.
+    DEFINE_OPTIONAL_DISPATCH(did_make);
+    DEFINE_OPTIONAL_DISPATCH(did_detach);
+
+    // Chunks sorted by address, so a slot's chunk can be found by binary search.
+    std::vector<std::unique_ptr<chunk> > chunks_{};
+    slot * free_ = nullptr;
+    size_type size_ = 0;
+};
+
+OWNING_TRACKER_TEMPLATE
+constexpr typename OWNING_TRACKER_TYPE::size_type OWNING_TRACKER_TYPE::chunk_size;
+
+OWNING_TRACKER_TEMPLATE
+OWNING_TRACKER_TYPE::
+owning_tracker(owning_tracker && rhs)
+    : chunks_{std::move(rhs.chunks_)}
+    , free_{rhs.free_}
+    , size_{rhs.size_}
+{
+    rhs.chunks_.clear();
+    rhs.free_ = nullptr;
+    rhs.size_ = 0;
+}
+
+OWNING_TRACKER_TEMPLATE
+OWNING_TRACKER_TYPE &
+OWNING_TRACKER_TYPE::
+operator=(owning_tracker && rhs)
+{
+    assert(this != &rhs);
+    destroy_all();
+    chunks_ = std::move(rhs.chunks_);
+    free_ = rhs.free_;
+    size_ = rhs.size_;
+    rhs.chunks_.clear();
+    rhs.free_ = nullptr;
+    rhs.size_ = 0;
+    return *this;
+}
+
+OWNING_TRACKER_TEMPLATE
+OWNING_TRACKER_TYPE::
+~owning_tracker()
+{
+    destroy_all();
+}
+
+OWNING_TRACKER_TEMPLATE
+template <typename ...Args>
+typename OWNING_TRACKER_TYPE::tracked_type &
+OWNING_TRACKER_TYPE::
+make(Args && ...args)
+{
+    if (not free_)
+    {
+        grow();
+    }
+
+    // Construct in the free slot, leaving it free if constructing throws.
+    slot * a_slot = free_;
+    slot * next = a_slot->next;
+    ::new (static_cast<void *>(&a_slot->value)) tracked_type{std::forward<Args>(args)...};
+    free_ = next;
+    auto && location = locate(a_slot);
+    location.first->set_occupied(location.second, true);
+    ++size_;
+
+    OPTIONAL_STATIC_DISPATCH(Derived, did_make, a_slot->value);
+    return a_slot->value;
+}
+
+OWNING_TRACKER_TEMPLATE
+void
+OWNING_TRACKER_TYPE::
+destroy(tracked_type & a_tracked)
+{
+    assert(is_attached(a_tracked));
+    OPTIONAL_STATIC_DISPATCH(Derived, did_detach, a_tracked);
+    auto && location = locate(&a_tracked);
+    location.first->set_occupied(location.second, false);
+    slot & a_slot = location.first->slots[location.second];
+    a_slot.value.~tracked_type();
+    a_slot.next = free_;
+    free_ = &a_slot;
+    --size_;
+}
+
+OWNING_TRACKER_TEMPLATE
+void
+OWNING_TRACKER_TYPE::
+destroy_all()
+{
+    // Note: chunks are freed after all objects are destroyed, any of which may be notified.
+    for (auto && a_chunk : chunks_)
+    {
+        for (size_type i = 0; i != Chunk_Size; ++i)
+        {
+            if (a_chunk->is_occupied(i))
+            {
+                OPTIONAL_STATIC_DISPATCH(Derived, did_detach, a_chunk->slots[i].value);
+                a_chunk->slots[i].value.~tracked_type();
+            }
+        }
+    }
+    chunks_.clear();
+    free_ = nullptr;
+    size_ = 0;
+}
+
+OWNING_TRACKER_TEMPLATE
+bool
+OWNING_TRACKER_TYPE::
+is_attached(tracked_type const & a_tracked) const
+{
+    auto && location = locate(&a_tracked);
+    return location.first and location.first->is_occupied(location.second);
+}
+
+OWNING_TRACKER_TEMPLATE
+template <typename Function>
+void
+OWNING_TRACKER_TYPE::
+for_each(Function && a_function)
+{
+    // Skip empty words of each chunk, and visit the rest in order.
+    // Note: indexing since making an object may add chunks, which are inserted in address order, so the current chunk is found again
+    // whenever one is added (which may move it to a later index) to never visit a chunk twice.
+    size_type count = chunks_.size();
+    for (size_type c = 0; c < chunks_.size(); ++c)
+    {
+        chunk * a_chunk = chunks_[c].get();
+        for (size_type w = 0; w != chunk::word_count; ++w)
+        {
+            // Note: shift a copy to stop after the last object of the word.
+            std::uint64_t word = a_chunk->occupied[w];
+            for (size_type b = 0; word; ++b, word >>= 1)
+            {
+                if ((word & 1) and a_chunk->is_occupied(w * 64 + b))
+                {
+                    a_function(a_chunk->slots[w * 64 + b].value);
+                }
+            }
+        }
+        if (chunks_.size() != count)
+        {
+            auto && less = std::less<void const *>{};
+            auto && position = std::lower_bound(std::begin(chunks_), std::end(chunks_), a_chunk,
+                [&less](std::unique_ptr<chunk> const & lhs, chunk const * rhs) { return less(lhs.get(), rhs); });
+            c = static_cast<size_type>(position - std::begin(chunks_));
+            count = chunks_.size();
+        }
+    }
+}
+
+OWNING_TRACKER_TEMPLATE
+std::pair<typename OWNING_TRACKER_TYPE::chunk *, typename OWNING_TRACKER_TYPE::size_type>
+OWNING_TRACKER_TYPE::
+locate(void const * a_address) const
+{
+    // Find the last chunk that starts at or before the address.
+    auto && less = std::less<void const *>{};
+    auto && after = std::upper_bound(std::begin(chunks_), std::end(chunks_), a_address,
+        [&less](void const * an_address, std::unique_ptr<chunk> const & a_chunk) { return less(an_address, a_chunk->slots); });
+    if (after == std::begin(chunks_))
+    {
+        return {nullptr, 0};
+    }
+    chunk * a_chunk = std::prev(after)->get();
+    if (not less(a_address, a_chunk->slots + Chunk_Size))
+    {
+        return {nullptr, 0};
+    }
+    auto const offset = static_cast<size_type>(static_cast<char const *>(a_address) - reinterpret_cast<char const *>(a_chunk->slots));
+    assert(offset % sizeof(slot) == 0);
+    return {a_chunk, offset / sizeof(slot)};
+}
+
+OWNING_TRACKER_TEMPLATE
+void
+OWNING_TRACKER_TYPE::
+grow()
+{
+    std::unique_ptr<chunk> a_chunk{new chunk{}};
+    for (size_type i = Chunk_Size; i-- > 0; )
+    {
+        a_chunk->slots[i].next = free_;
+        free_ = &a_chunk->slots[i];
+    }
+    auto && less = std::less<void const *>{};
+    auto && position = std::upper_bound(std::begin(chunks_), std::end(chunks_), a_chunk,
+        [&less](std::unique_ptr<chunk> const & lhs, std::unique_ptr<chunk> const & rhs) { return less(lhs.get(), rhs.get()); });
+    chunks_.insert(position, std::move(a_chunk));
+}
+
+#undef OWNING_TRACKER_TYPE
+#undef OWNING_TRACKER_TEMPLATE
+#undef OWNING_TRACKER_TEMPLATE_DECL
+
+}
+
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "span.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+// Vector whose values are grouped into Partition_Count contiguous partitions by a tag, so a tracker can visit the objects with a tag
+// without filtering all of its objects, using tracker::partition(). The tag of each value is given by Tag_Of, a function object that
+// takes a reference to a tracked object and returns a partition index less than Partition_Count, such as:
+//   struct state_of { std::size_t operator()(MyClass const & an_object) const { return an_object.is_active ? 1 : 0; } };
+//   wade::tracker<Mytracker, MyClass, wade::partitioned_vector<MyClass *, state_of, 2> >
+// Values are partitioned when inserted, and an object whose tag changes while attached is moved to its new partition by tracker::repartition().
+// Each value's position and partition are stored in its hook, and inserting, erasing, or moving a value moves at most one value of each
+// following partition, so these take constant time for a fixed number of partitions. Iteration order within a partition is not the order of insertion.
+template <typename T, typename Tag_Of, std::size_t Partition_Count>
+class partitioned_vector
+{
+    static_assert(Partition_Count > 0, "Must have at least one partition");
+
+    using vector_type = std::vector<T>;
+
+public:
+
+    using value_type = T;
+    using size_type = typename vector_type::size_type;
+    using difference_type = typename vector_type::difference_type;
+    using reference = typename vector_type::reference;
+    using const_reference = typename vector_type::const_reference;
+    using iterator = typename vector_type::const_iterator;
+    using const_iterator = typename vector_type::const_iterator;
+
+    // Position and partition of a value in the vector.
+    struct hook_type
+    {
+        size_type index = 0;
+        size_type partition = 0;
+    };
+
+    explicit partitioned_vector(Tag_Of a_tag_of = Tag_Of{})
+        : tag_of_(std::move(a_tag_of))
+    {
+    }
+
+    // Moving leaves rhs empty (with partitions that start at 0), and still able to insert since its function object is copied.
+    partitioned_vector(partitioned_vector const &) = default;
+    partitioned_vector & operator=(partitioned_vector const &) = default;
+    partitioned_vector(partitioned_vector && rhs)
+        : tag_of_(rhs.tag_of_)
+        , values_(std::move(rhs.values_))
+        , starts_(rhs.starts_)
+    {
+        rhs.clear();
+    }
+    partitioned_vector & operator=(partitioned_vector && rhs)
+    {
+        if (this != &rhs)
+        {
+            tag_of_ = rhs.tag_of_;
+            values_ = std::move(rhs.values_);
+            starts_ = rhs.starts_;
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    // Insert a value at the end of the partition of its tag.
+    template <typename Hook_Of>
+    void insert(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        size_type const a_partition = tag_of_(*a_value);
+        assert(a_partition < Partition_Count);
+        values_.push_back(value_type{});
+        place(open(a_partition, values_.size() - 1, a_hook_of), a_value, a_partition, a_hook_of);
+    }
+
+    // Erase a value by moving the last value of its partition into its position, and then the last value of each following partition back.
+    template <typename Hook_Of>
+    void erase(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        auto && a_hook = a_hook_of(a_value);
+        assert(a_hook.index < values_.size() and values_[a_hook.index] == a_value);
+        close(a_hook.partition, a_hook.index, a_hook_of);
+        values_.pop_back();
+    }
+
+    // Erase a value by replacing it with a null value, which does not move any other values.
+    template <typename Hook_Of>
+    void erase_deferred(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        auto && a_hook = a_hook_of(a_value);
+        assert(a_hook.index < values_.size() and values_[a_hook.index] == a_value);
+        values_[a_hook.index] = value_type{};
+    }
+
+    // Erase all null values, keeping the other values in order and updating their hooks.
+    template <typename Hook_Of>
+    void compact(Hook_Of const & a_hook_of)
+    {
+        size_type size = 0;
+        for (size_type p = 0; p != Partition_Count; ++p)
+        {
+            size_type const first = starts_[p];
+            size_type const last = end_of(p);
+            starts_[p] = size;
+            for (size_type i = first; i != last; ++i)
+            {
+                if (values_[i])
+                {
+                    a_hook_of(values_[i]).index = size;
+                    values_[size++] = values_[i];
+                }
+            }
+        }
+        values_.resize(size);
+    }
+
+    // Move a value to the partition of its tag if its tag has changed.
+    template <typename Hook_Of>
+    void repartition(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        auto && a_hook = a_hook_of(a_value);
+        assert(a_hook.index < values_.size() and values_[a_hook.index] == a_value);
+        size_type const a_partition = tag_of_(*a_value);
+        assert(a_partition < Partition_Count);
+        if (a_partition != a_hook.partition)
+        {
+            // Close the value's position, which leaves a hole at the end of the vector, and then open a position in its new partition.
+            close(a_hook.partition, a_hook.index, a_hook_of);
+            place(open(a_partition, values_.size() - 1, a_hook_of), a_value, a_partition, a_hook_of);
+        }
+    }
+
+    // Get the values in a partition.
+    span<value_type const> partition(size_type a_partition) const
+    {
+        assert(a_partition < Partition_Count);
+        return span<value_type const>{values_.data() + starts_[a_partition], end_of(a_partition) - starts_[a_partition]};
+    }
+
+    static constexpr size_type partition_count() { return Partition_Count; }
+
+    void clear() { values_.clear(); starts_.fill(0); }
+    void reserve(size_type a_capacity) { values_.reserve(a_capacity); }
+
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+    const_iterator cbegin() const { return values_.cbegin(); }
+    const_iterator cend() const { return values_.cend(); }
+
+    const_reference operator[](size_type a_index) const { return values_[a_index]; }
+    value_type const * data() const { return values_.data(); }
+
+    size_type size() const { return values_.size(); }
+    size_type capacity() const { return values_.capacity(); }
+    bool empty() const { return values_.empty(); }
+
+private:
+
+    size_type end_of(size_type a_partition) const { return a_partition + 1 != Partition_Count ? starts_[a_partition + 1] : values_.size(); }
+
+    // Store a value at a position and update its hook. Null values (of deferred erasures) have no hook.
+    template <typename Hook_Of>
+    void place(size_type a_index, value_type const & a_value, size_type a_partition, Hook_Of const & a_hook_of)
+    {
+        values_[a_index] = a_value;
+        if (a_value)
+        {
+            a_hook_of(a_value) = hook_type{a_index, a_partition};
+        }
+    }
+
+    // Move a hole at the end of the vector to the end of a partition by moving the first value of each following partition to its end.
+    // Returns the position of the hole.
+    template <typename Hook_Of>
+    size_type open(size_type a_partition, size_type a_hole, Hook_Of const & a_hook_of)
+    {
+        for (size_type p = Partition_Count - 1; p != a_partition; --p)
+        {
+            if (starts_[p] != a_hole)
+            {
+                place(a_hole, values_[starts_[p]], p, a_hook_of);
+            }
+            a_hole = starts_[p]++;
+        }
+        return a_hole;
+    }
+
+    // Fill a position by moving the last value of its partition into it, and then the last value of each following partition back,
+    // which leaves a hole at the end of the vector.
+    template <typename Hook_Of>
+    void close(size_type a_partition, size_type a_hole, Hook_Of const & a_hook_of)
+    {
+        for (size_type p = a_partition; p != Partition_Count; ++p)
+        {
+            size_type const last = end_of(p) - 1;
+            if (last != a_hole)
+            {
+                place(a_hole, values_[last], p, a_hook_of);
+            }
+            a_hole = last;
+            if (p + 1 != Partition_Count)
+            {
+                --starts_[p + 1];
+            }
+        }
+        values_[a_hole] = value_type{};
+    }
+
+    Tag_Of tag_of_;
+    vector_type values_{};
+
+    // First position of each partition, where each partition ends at the start of the next one.
+    std::array<size_type, Partition_Count> starts_{};
+};
+
+}
+
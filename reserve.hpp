@@ -0,0 +1,52 @@
+#pragma once
+
+
+namespace {
+
+template <class Container, class Size>
+auto reserve_impl(Container & a_container, Size a_capacity, int) -> decltype(a_container.reserve(a_capacity), void())
+{
+    a_container.reserve(a_capacity);
+}
+
+template <class Container, class Size>
+void reserve_impl(Container &, Size, long)
+{
+}
+
+template <class Container>
+auto is_full_impl(Container const & a_container, int) -> decltype(a_container.full(), bool())
+{
+    return a_container.full();
+}
+
+template <class Container>
+bool is_full_impl(Container const &, long)
+{
+    return false;
+}
+
+}
+
+namespace wade {
+
+// Reserve capacity in a container.
+// Uses SFINAE (like wade::find()) to call the container's reserve() member function if it has one (i.e., std::vector),
+// and does nothing otherwise (i.e., std::set).
+template <class Container, class Size>
+void reserve(Container & a_container, Size a_capacity)
+{
+    reserve_impl(a_container, a_capacity, 0);
+}
+
+// Whether a container (or allocator) with a fixed capacity is full.
+// Uses SFINAE like wade::reserve() to call its full() member function if it has one (i.e., wade::fixed_unordered_vector),
+// and is never full otherwise (i.e., std::vector).
+template <class Container>
+bool is_full(Container const & a_container)
+{
+    return is_full_impl(a_container, 0);
+}
+
+}
+
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+// Slot map that stores values contiguously and refers to them by stable, generation-tagged handles.
+// Values live in a dense vector for fast iteration (in no particular order), while a sparse vector of slots maps handles to dense positions.
+// Erased slots are reused through a free list and their generation is incremented, so handles to erased values become stale instead of dangling.
+// Inserting, erasing, and looking up a value by handle are all constant time.
+// Each value's handle is stored in its hook, so a tracked object's handle is available from my_hook(). For example:
+//   TRACKER_WITH_CONTAINER(Mytracker, MyClass, wade::slot_map)
+//   auto && handle = instance->my_hook();
+//   auto && value = tracker.tracked_objects().get(handle); // nullptr once instance is detached.
+template <typename T>
+class slot_map
+{
+    using vector_type = std::vector<T>;
+    using index_type = std::uint32_t;
+
+    static constexpr index_type npos = std::numeric_limits<index_type>::max();
+
+public:
+
+    using value_type = T;
+    using size_type = typename vector_type::size_type;
+    using difference_type = typename vector_type::difference_type;
+    using reference = typename vector_type::reference;
+    using const_reference = typename vector_type::const_reference;
+    using iterator = typename vector_type::const_iterator;
+    using const_iterator = typename vector_type::const_iterator;
+
+    // Weak reference to a value.
+    // A default-constructed handle never refers to a value.
+    struct handle_type
+    {
+        index_type index = npos;
+        index_type generation = 0;
+
+        friend bool operator==(handle_type const & lhs, handle_type const & rhs) { return lhs.index == rhs.index and lhs.generation == rhs.generation; }
+        friend bool operator!=(handle_type const & lhs, handle_type const & rhs) { return not (lhs == rhs); }
+    };
+
+    using hook_type = handle_type;
+
+    slot_map() = default;
+    slot_map(slot_map const &) = default;
+    slot_map & operator=(slot_map const &) = default;
+
+    // Moving leaves the moved-from slot map empty, including its free list.
+    slot_map(slot_map && rhs)
+        : values_{std::move(rhs.values_)}
+        , value_slots_{std::move(rhs.value_slots_)}
+        , slots_{std::move(rhs.slots_)}
+        , free_head_{std::exchange(rhs.free_head_, npos)}
+    {
+        rhs.values_.clear();
+        rhs.value_slots_.clear();
+        rhs.slots_.clear();
+    }
+    slot_map & operator=(slot_map && rhs)
+    {
+        assert(this != &rhs);
+        values_ = std::move(rhs.values_);
+        value_slots_ = std::move(rhs.value_slots_);
+        slots_ = std::move(rhs.slots_);
+        free_head_ = std::exchange(rhs.free_head_, npos);
+        rhs.values_.clear();
+        rhs.value_slots_.clear();
+        rhs.slots_.clear();
+        return *this;
+    }
+
+    // Insert a value into a free slot and store the slot's handle in its hook.
+    template <typename Hook_Of>
+    void insert(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        index_type slot_index = free_head_;
+        if (slot_index == npos)
+        {
+            assert(slots_.size() < npos);
+            slot_index = static_cast<index_type>(slots_.size());
+            slots_.emplace_back();
+        }
+        else
+        {
+            free_head_ = slots_[slot_index].index;
+        }
+
+        slot & a_slot = slots_[slot_index];
+        a_slot.index = static_cast<index_type>(values_.size());
+        values_.push_back(a_value);
+        value_slots_.push_back(slot_index);
+        a_hook_of(a_value) = handle_type{slot_index, a_slot.generation};
+    }
+
+    // Erase a value by moving the last value into its dense position and freeing its slot.
+    // Handles of moved values do not change since their slots only need to be pointed at the new position.
+    template <typename Hook_Of>
+    void erase(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        handle_type const handle = a_hook_of(a_value);
+        assert(contains(handle) and get(handle) == a_value);
+        slot & a_slot = slots_[handle.index];
+        index_type const index = a_slot.index;
+        if (index + 1 != values_.size())
+        {
+            values_[index] = values_.back();
+            value_slots_[index] = value_slots_.back();
+            slots_[value_slots_[index]].index = index;
+        }
+        values_.pop_back();
+        value_slots_.pop_back();
+        release(handle.index);
+    }
+
+    // Erase a value by replacing it with a null value, which does not move any other values.
+    // Its slot is freed immediately, so its handle is already stale.
+    template <typename Hook_Of>
+    void erase_deferred(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        handle_type const handle = a_hook_of(a_value);
+        assert(contains(handle) and get(handle) == a_value);
+        values_[slots_[handle.index].index] = value_type{};
+        release(handle.index);
+    }
+
+    // Erase all null values, keeping the other values in order and pointing their slots at their new positions.
+    // Handles do not change.
+    template <typename Hook_Of>
+    void compact(Hook_Of const &)
+    {
+        index_type size = 0;
+        for (size_type i = 0; i != values_.size(); ++i)
+        {
+            if (values_[i])
+            {
+                values_[size] = values_[i];
+                value_slots_[size] = value_slots_[i];
+                slots_[value_slots_[size]].index = size;
+                ++size;
+            }
+        }
+        values_.resize(size);
+        value_slots_.resize(size);
+    }
+
+    // Whether a handle refers to a value in this slot map.
+    bool contains(handle_type const & a_handle) const
+    {
+        return a_handle.index < slots_.size() and slots_[a_handle.index].generation == a_handle.generation;
+    }
+
+    // Get the value a handle refers to. Returns a null (value-initialized) value if the handle is stale.
+    value_type get(handle_type const & a_handle) const
+    {
+        return contains(a_handle) ? values_[slots_[a_handle.index].index] : value_type{};
+    }
+
+    // Erase all values, which makes all handles stale.
+    void clear()
+    {
+        for (auto && slot_index : value_slots_)
+        {
+            release(slot_index);
+        }
+        values_.clear();
+        value_slots_.clear();
+    }
+
+    void reserve(size_type a_capacity)
+    {
+        values_.reserve(a_capacity);
+        value_slots_.reserve(a_capacity);
+        slots_.reserve(a_capacity);
+    }
+
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+    const_iterator cbegin() const { return values_.cbegin(); }
+    const_iterator cend() const { return values_.cend(); }
+
+    const_reference operator[](size_type a_index) const { return values_[a_index]; }
+    value_type const * data() const { return values_.data(); }
+
+    size_type size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+
+private:
+
+    // Position of a value in the dense vector (or the next free slot when unused) and the slot's current generation.
+    struct slot
+    {
+        index_type index = npos;
+        index_type generation = 0;
+    };
+
+    // Free a slot, which invalidates its handles.
+    void release(index_type a_slot_index)
+    {
+        slot & a_slot = slots_[a_slot_index];
+        ++a_slot.generation;
+        a_slot.index = free_head_;
+        free_head_ = a_slot_index;
+    }
+
+    vector_type values_{};
+    std::vector<index_type> value_slots_{};
+    std::vector<slot> slots_{};
+    index_type free_head_ = npos;
+};
+
+template <typename T>
+constexpr typename slot_map<T>::index_type slot_map<T>::npos;
+
+}
+
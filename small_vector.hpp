@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+
+namespace wade {
+
+// Vector that stores up to Inline_Capacity values inside itself, and only allocates once it holds more, so a tracker that usually holds
+// few objects never allocates to attach them, and making an empty tracker never allocates at all.
+// Otherwise behaves like std::vector (i.e., keeps values in order of insertion and has contiguous data()), so detaching can be deferred
+// and chunks are visited in place. Only values that can be copied as bytes (i.e., pointers) are stored. For example:
+//   TRACKER_WITH_CONTAINER(Mytracker, MyClass, wade::small_vector)
+//   wade::tracker<Mytracker, MyClass, wade::small_vector<MyClass *, 4> >
+template <typename T, std::size_t Inline_Capacity = 8>
+class small_vector
+{
+    static_assert(Inline_Capacity > 0, "Must store at least one value inline");
+    static_assert(std::is_trivially_copyable<T>::value, "Values must be trivially copyable");
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = value_type const &;
+    using iterator = value_type *;
+    using const_iterator = value_type const *;
+
+    static constexpr size_type inline_capacity = Inline_Capacity;
+
+    small_vector() = default;
+    small_vector(small_vector const & rhs) { *this = rhs; }
+    small_vector & operator=(small_vector const &);
+
+    // Moving takes the allocated values of rhs, or copies its inline values, and leaves rhs empty.
+    small_vector(small_vector && rhs) { *this = std::move(rhs); }
+    small_vector & operator=(small_vector &&);
+
+    // Insert a value before a position, growing the storage if needed.
+    iterator insert(const_iterator, value_type const &);
+    void push_back(value_type const & a_value) { insert(end(), a_value); }
+
+    // Erase values, moving the following values forward. Returns the position following the erased values.
+    iterator erase(const_iterator a_position) { return erase(a_position, a_position + 1); }
+    iterator erase(const_iterator, const_iterator);
+
+    // Erase all values, keeping any allocated storage for reuse.
+    void clear() { size_ = 0; }
+
+    // Grow the storage so that it holds a number of values without growing again.
+    void reserve(size_type);
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reference operator[](size_type a_index) { assert(a_index < size_); return data()[a_index]; }
+    const_reference operator[](size_type a_index) const { assert(a_index < size_); return data()[a_index]; }
+    value_type * data() { return allocated_ ? allocated_.get() : inline_values_; }
+    value_type const * data() const { return allocated_ ? allocated_.get() : inline_values_; }
+
+    size_type size() const { return size_; }
+    size_type capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    // Whether values are stored inside the vector rather than allocated.
+    bool is_inline() const { return not allocated_; }
+
+private:
+
+    // Move all values into allocated storage for a number of values, which must be more than the inline capacity.
+    void reallocate(size_type);
+
+    value_type inline_values_[Inline_Capacity];
+    std::unique_ptr<value_type[]> allocated_{};
+    size_type size_ = 0;
+    size_type capacity_ = Inline_Capacity;
+};
+
+template <typename T, std::size_t Inline_Capacity>
+constexpr typename small_vector<T, Inline_Capacity>::size_type small_vector<T, Inline_Capacity>::inline_capacity;
+
+template <typename T, std::size_t Inline_Capacity>
+small_vector<T, Inline_Capacity> &
+small_vector<T, Inline_Capacity>::
+operator=(small_vector const & rhs)
+{
+    if (this != &rhs)
+    {
+        size_ = 0;
+        reserve(rhs.size_);
+        std::copy(rhs.begin(), rhs.end(), data());
+        size_ = rhs.size_;
+    }
+    return *this;
+}
+
+template <typename T, std::size_t Inline_Capacity>
+small_vector<T, Inline_Capacity> &
+small_vector<T, Inline_Capacity>::
+operator=(small_vector && rhs)
+{
+    if (this != &rhs)
+    {
+        if (rhs.allocated_)
+        {
+            allocated_ = std::move(rhs.allocated_);
+            capacity_ = rhs.capacity_;
+        }
+        else
+        {
+            allocated_.reset();
+            capacity_ = Inline_Capacity;
+            std::copy(rhs.begin(), rhs.end(), inline_values_);
+        }
+        size_ = rhs.size_;
+        rhs.size_ = 0;
+        rhs.capacity_ = Inline_Capacity;
+    }
+    return *this;
+}
+
+template <typename T, std::size_t Inline_Capacity>
+typename small_vector<T, Inline_Capacity>::iterator
+small_vector<T, Inline_Capacity>::
+insert(const_iterator a_position, value_type const & a_value)
+{
+    assert(begin() <= a_position and a_position <= end());
+    auto const index = static_cast<size_type>(a_position - begin());
+
+    // Note: copy the value first since it may be in the storage that is reallocated or shifted.
+    value_type const a_copy = a_value;
+    if (size_ == capacity_)
+    {
+        reallocate(capacity_ * 2);
+    }
+    iterator const position = begin() + index;
+    std::copy_backward(position, end(), end() + 1);
+    *position = a_copy;
+    ++size_;
+    return position;
+}
+
+template <typename T, std::size_t Inline_Capacity>
+typename small_vector<T, Inline_Capacity>::iterator
+small_vector<T, Inline_Capacity>::
+erase(const_iterator a_first, const_iterator a_last)
+{
+    assert(begin() <= a_first and a_first <= a_last and a_last <= end());
+    iterator const first = begin() + (a_first - begin());
+    iterator const last = begin() + (a_last - begin());
+    std::copy(last, end(), first);
+    size_ -= static_cast<size_type>(last - first);
+    return first;
+}
+
+template <typename T, std::size_t Inline_Capacity>
+void
+small_vector<T, Inline_Capacity>::
+reserve(size_type a_capacity)
+{
+    if (a_capacity > capacity_)
+    {
+        reallocate(std::max(a_capacity, capacity_ * 2));
+    }
+}
+
+template <typename T, std::size_t Inline_Capacity>
+void
+small_vector<T, Inline_Capacity>::
+reallocate(size_type a_capacity)
+{
+    assert(a_capacity > Inline_Capacity and a_capacity >= size_);
+    std::unique_ptr<value_type[]> values{new value_type[a_capacity]};
+    std::copy(begin(), end(), values.get());
+    allocated_ = std::move(values);
+    capacity_ = a_capacity;
+}
+
+}
+
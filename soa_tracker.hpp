@@ -0,0 +1,459 @@
+#pragma once
+
+#include "allocator.hpp"
+#include "span.hpp"
+#include "static_dispatch.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+// Aliases for long template names (not part of interface and will be undefined).
+#define SOA_TRACKER_TEMPLATE template <typename Derived, typename ...Fields>
+#define SOA_TRACKER_TYPE soa_tracker<Derived, Fields...>
+
+// Factory that tracks made objects whose fields are stored as a structure of arrays (SoA).
+// Each field type is given as a template parameter, and the tracker stores each field of all objects in its own contiguous column,
+// so a loop over one field of all objects only touches that field's memory and can be vectorized. For example:
+//   struct Mytracker : wade::soa_tracker<Mytracker, Position, Velocity> { ... };
+//   auto && positions = tracker.column<0>();
+//   auto && velocities = tracker.column<1>();
+//   for (std::size_t i = 0; i != positions.size(); ++i) { positions[i] += velocities[i]; }
+// Use make() to construct an object's fields, which returns a handle that owns them (like a std::unique_ptr to a trackable object).
+// An object's fields are destroyed with its handle, or when its handle detaches it.
+// Objects are stored in no particular order, since detaching moves the last object's fields into the detached object's row.
+// Fields of type bool are not supported since std::vector<bool> has no contiguous data.
+// Each column is aligned and padded to column_alignment bytes (enough for any SIMD width), and for_each_chunk() visits columns
+// in chunks that each start aligned, so loops over chunks can be vectorized by the compiler or with intrinsics.
+//
+// Derive from this class and pass the derived class as the first template parameter (CRTP / static polymorphism).
+// The derived class may define any of these methods, and methods that are not defined are not called at all (like wade::tracker's):
+//   void did_make(handle &); // Called by make() after constructing an object's fields.
+//   void did_detach(handle &); // Called by detach() before an object's fields are destroyed, which must not make or detach any object.
+SOA_TRACKER_TEMPLATE
+class soa_tracker
+{
+    static_assert(sizeof...(Fields) > 0, "soa_tracker must have at least one field");
+
+public:
+
+    using size_type = std::size_t;
+    template <size_type I>
+    using field_type = typename std::tuple_element<I, std::tuple<Fields...> >::type;
+
+    static constexpr size_type field_count = sizeof...(Fields);
+
+    // Alignment of each column, and the number of rows in each chunk visited by for_each_chunk().
+    // Chunks start at multiples of chunk_size rows, which keeps them aligned.
+    static constexpr size_type column_alignment = 64;
+    static constexpr size_type chunk_size = 1024;
+
+    // Moveable but not copyable.
+    // Movement is not defaulted as it transfers tracked objects.
+    soa_tracker() = default;
+    soa_tracker(soa_tracker const &) = delete;
+    soa_tracker & operator=(soa_tracker const &) = delete;
+    soa_tracker(soa_tracker &&);
+    soa_tracker & operator=(soa_tracker &&);
+
+    // Owner of an object's fields (a proxy for the object).
+    // Detaches the object from its tracker when destroyed.
+    // Moveable but not copyable.
+    class handle
+    {
+    public:
+
+        // Detached by default.
+        handle() = default;
+        handle(handle const &) = delete;
+        handle & operator=(handle const &) = delete;
+
+        // Moving transfers the object.
+        handle(handle && rhs)
+            : tracker_{rhs.tracker_}
+            , index_{rhs.index_}
+        {
+            take(rhs);
+        }
+        handle & operator=(handle && rhs)
+        {
+            assert(this != &rhs);
+            detach();
+            tracker_ = rhs.tracker_;
+            index_ = rhs.index_;
+            take(rhs);
+            return *this;
+        }
+
+        // Deleting detaches from the tracker.
+        ~handle()
+        {
+            detach();
+        }
+
+        // Detach this object, which destroys its fields.
+        // Returns true if successful and false otherwise.
+        bool detach()
+        {
+            if (is_attached())
+            {
+                tracker_->erase(index_);
+                assert(is_detached());
+                return true;
+            }
+            return false;
+        }
+
+        // Get this tracker. Returns nullptr if not attached.
+        soa_tracker * my_tracker() { return tracker_; }
+        soa_tracker const * my_tracker() const { return tracker_; }
+
+        // Whether this object is attached to any tracker or not.
+        bool is_attached() const { return my_tracker() != nullptr; }
+        bool is_detached() const { return not is_attached(); }
+
+        // Get this object's row in its tracker's columns, which may change when other objects are detached.
+        // Only meaningful while attached.
+        size_type my_index() const { return index_; }
+
+        // Get a field of this object. Must be attached.
+        template <size_type I>
+        field_type<I> & get() { assert(is_attached()); return tracker_->template column<I>()[index_]; }
+        template <size_type I>
+        field_type<I> const & get() const { assert(is_attached()); return static_cast<soa_tracker const *>(tracker_)->template column<I>()[index_]; }
+
+    private:
+
+        friend class soa_tracker;
+
+        // Take the object of a handle whose tracker and index were just copied.
+        void take(handle & rhs)
+        {
+            if (tracker_)
+            {
+                tracker_->owners_[index_] = this;
+            }
+            rhs.tracker_ = nullptr;
+        }
+
+        // Non-owning pointer to tracker.
+        // Detached by default.
+        soa_tracker * tracker_ = nullptr;
+        size_type index_ = 0;
+    };
+
+    // Make an attached object by constructing each field with the corresponding argument,
+    // or by value-initializing all fields if there are no arguments.
+    // Calls did_make() after constructing.
+    template <typename ...Args>
+    handle make(Args && ...);
+
+    // Detach all objects, which destroys their fields.
+    void detach_all();
+
+    // Get one field of all objects in a contiguous column, in the same order for every field.
+    // Making or detaching objects invalidates columns.
+    template <size_type I>
+    wade::span<field_type<I> > column() { auto && a_column = std::get<I>(columns_); return {a_column.data(), a_column.size()}; }
+    template <size_type I>
+    wade::span<field_type<I> const> column() const { auto && a_column = std::get<I>(columns_); return {a_column.data(), a_column.size()}; }
+
+    // Call a function with references to the given fields of each object, in row order. For example:
+    //   tracker.for_each<0, 1>([](Position & a_position, Velocity const & a_velocity) { a_position += a_velocity; });
+    // The function must not make or detach any object.
+    template <size_type ...I, typename Function>
+    void for_each(Function &&);
+
+    // Call a function with spans of the given fields for consecutive chunks of rows, in row order. For example:
+    //   tracker.for_each_chunk<0, 1>([](wade::span<Position> a_positions, wade::span<Velocity> a_velocities) { ... });
+    // Spans of each chunk have the same size (at most chunk_size), and each starts at an address aligned to column_alignment.
+    // The function must not make or detach any object.
+    template <size_type ...I, typename Function>
+    void for_each_chunk(Function &&);
+
+    // Call a function for each chunk like the overload above, but in parallel with an executor (such as wade::thread_pool).
+    // The function may be called concurrently for different chunks.
+    // Must not be called from a task running on the same executor (see thread_pool::parallel_for()).
+    template <size_type ...I, typename Executor, typename Function>
+    void for_each_chunk(Executor &, Function &&);
+
+    // Get the handle that owns the object in a row of the columns.
+    handle & owner(size_type a_index) const { assert(a_index < size()); return *owners_[a_index]; }
+
+    // Number of attached objects, which is the size of every column.
+    size_type size() const { return owners_.size(); }
+    bool empty() const { return owners_.empty(); }
+
+    // Reserve space in every column.
+    void reserve(size_type);
+
+protected:
+
+    // Destructor detaches all objects.
+    // Protected destructor since should not have a tracker base class pointer to a derived class instance.
+    ~soa_tracker();
+
+private:
+
+    using index_sequence = std::index_sequence_for<Fields...>;
+
+    // Append a row to every column, either from one argument per field or by value-initializing each field.
+    template <std::size_t ...I, typename ...Args>
+    void push_row(std::index_sequence<I...>, Args && ...);
+    template <std::size_t ...I>
+    void push_row(std::index_sequence<I...>);
+
+    // Move the last row into another row, then remove the last row.
+    template <std::size_t ...I>
+    void pop_row(size_type, std::index_sequence<I...>);
+
+    // Remove rows from every column until all are the given size.
+    template <std::size_t ...I>
+    void resize_rows(size_type, std::index_sequence<I...>);
+
+    template <std::size_t ...I>
+    void reserve_rows(size_type, std::index_sequence<I...>);
+
+    // Detach the object in a row, which is called by its handle.
+    void erase(size_type);
+
+    // Call the derived class's methods only if defined.
+    DEFINE_OPTIONAL_DISPATCH(did_make);
+    DEFINE_OPTIONAL_DISPATCH(did_detach);
+
+    template <typename T>
+    using column_type = std::vector<T, aligned_allocator<T, column_alignment> >;
+
+    std::tuple<column_type<Fields>...> columns_{};
+    std::vector<handle *> owners_{};
+};
+
+SOA_TRACKER_TEMPLATE
+constexpr typename SOA_TRACKER_TYPE::size_type SOA_TRACKER_TYPE::field_count;
+SOA_TRACKER_TEMPLATE
+constexpr typename SOA_TRACKER_TYPE::size_type SOA_TRACKER_TYPE::column_alignment;
+SOA_TRACKER_TEMPLATE
+constexpr typename SOA_TRACKER_TYPE::size_type SOA_TRACKER_TYPE::chunk_size;
+
+SOA_TRACKER_TEMPLATE
+SOA_TRACKER_TYPE::
+soa_tracker(soa_tracker && rhs)
+    : columns_{std::move(rhs.columns_)}
+    , owners_{std::move(rhs.owners_)}
+{
+    // Attach new objects.
+    for (auto && a_handle : owners_)
+    {
+        a_handle->tracker_ = this;
+    }
+    rhs.resize_rows(0, index_sequence{});
+    rhs.owners_.clear();
+}
+
+SOA_TRACKER_TEMPLATE
+SOA_TRACKER_TYPE &
+SOA_TRACKER_TYPE::
+operator=(soa_tracker && rhs)
+{
+    // Detach all old objects and attach new objects.
+    assert(this != &rhs);
+    detach_all();
+    columns_ = std::move(rhs.columns_);
+    owners_ = std::move(rhs.owners_);
+    for (auto && a_handle : owners_)
+    {
+        a_handle->tracker_ = this;
+    }
+    rhs.resize_rows(0, index_sequence{});
+    rhs.owners_.clear();
+    return *this;
+}
+
+SOA_TRACKER_TEMPLATE
+SOA_TRACKER_TYPE::
+~soa_tracker()
+{
+    detach_all();
+}
+
+SOA_TRACKER_TEMPLATE
+template <typename ...Args>
+typename SOA_TRACKER_TYPE::handle
+SOA_TRACKER_TYPE::
+make(Args && ...args)
+{
+    static_assert(sizeof...(Args) == 0 or sizeof...(Args) == sizeof...(Fields), "make() takes either no arguments or one for each field");
+
+    // Construct fields, removing any that were constructed if one throws so all columns stay the same size.
+    handle a_handle{};
+    owners_.push_back(&a_handle);
+    try
+    {
+        push_row(index_sequence{}, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        owners_.pop_back();
+        resize_rows(owners_.size(), index_sequence{});
+        throw;
+    }
+
+    // Attach and notify.
+    // Note: returning moves the handle, which updates its owner.
+    a_handle.tracker_ = this;
+    a_handle.index_ = owners_.size() - 1;
+    OPTIONAL_STATIC_DISPATCH(Derived, did_make, a_handle);
+    return a_handle;
+}
+
+SOA_TRACKER_TEMPLATE
+void
+SOA_TRACKER_TYPE::
+detach_all()
+{
+    // Detach all objects.
+    // Note: not calling detach() since it will move rows, which may invalidate loop iteration.
+    for (auto && a_handle : owners_)
+    {
+        // Note: did_detach() is called while the object's fields are still accessible.
+        OPTIONAL_STATIC_DISPATCH(Derived, did_detach, *a_handle);
+        a_handle->tracker_ = nullptr;
+    }
+    resize_rows(0, index_sequence{});
+    owners_.clear();
+}
+
+SOA_TRACKER_TEMPLATE
+template <std::size_t ...I, typename Function>
+void
+SOA_TRACKER_TYPE::
+for_each(Function && a_function)
+{
+    for (size_type i = 0; i != size(); ++i)
+    {
+        a_function(std::get<I>(columns_)[i]...);
+    }
+}
+
+SOA_TRACKER_TEMPLATE
+template <std::size_t ...I, typename Function>
+void
+SOA_TRACKER_TYPE::
+for_each_chunk(Function && a_function)
+{
+    for (size_type first = 0; first < size(); first += chunk_size)
+    {
+        size_type const count = std::min(chunk_size, size() - first);
+        a_function(column<I>().subspan(first, count)...);
+    }
+}
+
+SOA_TRACKER_TEMPLATE
+template <std::size_t ...I, typename Executor, typename Function>
+void
+SOA_TRACKER_TYPE::
+for_each_chunk(Executor & a_executor, Function && a_function)
+{
+    a_executor.parallel_for((size() + chunk_size - 1) / chunk_size, [this, &a_function](size_type a_chunk)
+    {
+        size_type const first = a_chunk * chunk_size;
+        size_type const count = std::min(chunk_size, size() - first);
+        a_function(column<I>().subspan(first, count)...);
+    });
+}
+
+SOA_TRACKER_TEMPLATE
+void
+SOA_TRACKER_TYPE::
+reserve(size_type a_capacity)
+{
+    reserve_rows(a_capacity, index_sequence{});
+    owners_.reserve(a_capacity);
+}
+
+SOA_TRACKER_TEMPLATE
+template <std::size_t ...I, typename ...Args>
+void
+SOA_TRACKER_TYPE::
+push_row(std::index_sequence<I...>, Args && ...args)
+{
+    // Note: expanding into an array to call a function for each column in order (c++14 has no fold expressions).
+    using expand = int[];
+    (void)expand{0, (std::get<I>(columns_).emplace_back(std::forward<Args>(args)), 0)...};
+}
+
+SOA_TRACKER_TEMPLATE
+template <std::size_t ...I>
+void
+SOA_TRACKER_TYPE::
+push_row(std::index_sequence<I...>)
+{
+    using expand = int[];
+    (void)expand{0, (std::get<I>(columns_).emplace_back(), 0)...};
+}
+
+SOA_TRACKER_TEMPLATE
+template <std::size_t ...I>
+void
+SOA_TRACKER_TYPE::
+pop_row(size_type a_index, std::index_sequence<I...>)
+{
+    using expand = int[];
+    (void)expand{0, (std::get<I>(columns_)[a_index] = std::move(std::get<I>(columns_).back()), std::get<I>(columns_).pop_back(), 0)...};
+}
+
+SOA_TRACKER_TEMPLATE
+template <std::size_t ...I>
+void
+SOA_TRACKER_TYPE::
+resize_rows(size_type a_size, std::index_sequence<I...>)
+{
+    using expand = int[];
+    (void)expand{0, (std::get<I>(columns_).erase(std::get<I>(columns_).begin() + a_size, std::get<I>(columns_).end()), 0)...};
+}
+
+SOA_TRACKER_TEMPLATE
+template <std::size_t ...I>
+void
+SOA_TRACKER_TYPE::
+reserve_rows(size_type a_capacity, std::index_sequence<I...>)
+{
+    using expand = int[];
+    (void)expand{0, (std::get<I>(columns_).reserve(a_capacity), 0)...};
+}
+
+SOA_TRACKER_TEMPLATE
+void
+SOA_TRACKER_TYPE::
+erase(size_type a_index)
+{
+    // Notify while fields are accessible, then move the last row into the erased row.
+    assert(a_index < size());
+    handle * a_handle = owners_[a_index];
+    OPTIONAL_STATIC_DISPATCH(Derived, did_detach, *a_handle);
+    size_type const last = owners_.size() - 1;
+    if (a_index != last)
+    {
+        pop_row(a_index, index_sequence{});
+        owners_[a_index] = owners_[last];
+        owners_[a_index]->index_ = a_index;
+    }
+    else
+    {
+        resize_rows(last, index_sequence{});
+    }
+    owners_.pop_back();
+    a_handle->tracker_ = nullptr;
+}
+
+#undef SOA_TRACKER_TYPE
+#undef SOA_TRACKER_TEMPLATE
+
+}
+
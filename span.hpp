@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+
+namespace wade {
+
+// Non-owning view of a contiguous sequence of objects (a minimal std::span for c++14).
+template <typename T>
+class span
+{
+public:
+
+    using element_type = T;
+    using size_type = std::size_t;
+    using iterator = T *;
+
+    span() = default;
+    span(T * a_data, size_type a_size)
+        : data_{a_data}
+        , size_{a_size}
+    {
+    }
+
+    // Any container with contiguous data() and size() converts to a span.
+    template <typename Container, typename = decltype(static_cast<T *>(std::declval<Container &>().data()))>
+    span(Container & a_container)
+        : span{a_container.data(), a_container.size()}
+    {
+    }
+
+    iterator begin() const { return data_; }
+    iterator end() const { return data_ + size_; }
+
+    T & operator[](size_type a_index) const { assert(a_index < size_); return data_[a_index]; }
+    T * data() const { return data_; }
+
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Get a view of count objects starting at offset.
+    span subspan(size_type a_offset, size_type a_count) const
+    {
+        assert(a_offset + a_count <= size_);
+        return span{data_ + a_offset, a_count};
+    }
+
+private:
+
+    T * data_ = nullptr;
+    size_type size_ = 0;
+};
+
+}
+
@@ -1,5 +1,37 @@
 #pragma once
 
+#include <type_traits>
+#include <utility>
+
 // Macro to call derived class member function from base class.
 #define STATIC_DISPATCH(T, FUNC, ...) (static_cast<T *>(this)->T::FUNC(__VA_ARGS__))
 
+// Macro to define a trait for whether a class has a member function callable with the given argument types,
+// which is used to make dispatching to a derived class member function optional.
+// Use inside the base class so that access is checked from the base class (i.e., for private members of a derived class that befriends it).
+// For example:
+//   DEFINE_HAS_MEMBER_FUNCTION(has_did_make, did_make)
+//   has_did_make<Derived, Tracked_T &>::value
+#define DEFINE_HAS_MEMBER_FUNCTION(TRAIT, FUNC) \
+    template <typename T, typename ...Args> \
+    static auto TRAIT##_test(int) -> decltype(std::declval<T &>().FUNC(std::declval<Args>()...), std::true_type{}); \
+    template <typename T, typename ...Args> \
+    static std::false_type TRAIT##_test(long); \
+    template <typename T, typename ...Args> \
+    using TRAIT = decltype(TRAIT##_test<T, Args...>(0))
+
+// Macros to call a derived class member function from a base class only if the derived class defines it,
+// which otherwise compiles to nothing. Use DEFINE_OPTIONAL_DISPATCH inside the base class (like DEFINE_HAS_MEMBER_FUNCTION)
+// for each optional member function, then OPTIONAL_STATIC_DISPATCH like STATIC_DISPATCH. For example:
+//   DEFINE_OPTIONAL_DISPATCH(did_make);
+//   OPTIONAL_STATIC_DISPATCH(Derived, did_make, *a_trackable);
+#define DEFINE_OPTIONAL_DISPATCH(FUNC) \
+    template <typename T, typename ...Args> \
+    static auto FUNC##_dispatch(T & a_derived, int, Args && ...args) -> decltype(a_derived.T::FUNC(std::forward<Args>(args)...), void()) \
+    { \
+        a_derived.T::FUNC(std::forward<Args>(args)...); \
+    } \
+    template <typename T, typename ...Args> \
+    static void FUNC##_dispatch(T &, long, Args && ...) {} \
+    static_assert(true, "")
+#define OPTIONAL_STATIC_DISPATCH(T, FUNC, ...) (FUNC##_dispatch(*static_cast<T *>(this), 0, __VA_ARGS__))
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace wade {
+
+// Fixed number of worker threads that run submitted tasks in order of submission.
+// Also an executor for the parallel overloads of tracker::for_each() and similar methods, which call parallel_for().
+// An executor is any class with a method that calls a function for every index in [0, count) and returns when all calls are done:
+//   template <typename Function> void parallel_for(std::size_t count, Function &&);
+// Destroying the pool waits for all submitted tasks to finish.
+class thread_pool
+{
+public:
+
+    using size_type = std::size_t;
+
+    // Construct with a number of worker threads, which defaults to one less than the number of cores
+    // since the thread calling parallel_for() also runs tasks.
+    explicit thread_pool(size_type a_thread_count = default_thread_count())
+    {
+        workers_.reserve(a_thread_count);
+        for (size_type i = 0; i != a_thread_count; ++i)
+        {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    thread_pool(thread_pool const &) = delete;
+    thread_pool & operator=(thread_pool const &) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto && a_worker : workers_)
+        {
+            a_worker.join();
+        }
+    }
+
+    // Number of worker threads, which may be 0 (i.e., tasks only run in parallel_for()).
+    size_type size() const { return workers_.size(); }
+
+    // Run a task on a worker thread.
+    // Tasks must not throw, since there is no one to catch an exception.
+    void submit(std::function<void()> a_task)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            tasks_.push_back(std::move(a_task));
+        }
+        ready_.notify_one();
+    }
+
+    // Call a function with each index in [0, count) across the calling thread and worker threads, and return when all calls are done.
+    // Indices are claimed one at a time, so calls with different indices may run in any order and at the same time.
+    // If any call throws, remaining indices are skipped and the first exception is rethrown.
+    // Must not be called from a task running on this pool (including the function given to parallel_for()),
+    // since it waits for tasks that may be queued behind the worker it blocks, which deadlocks once every worker waits.
+    template <typename Function>
+    void parallel_for(size_type a_count, Function && a_function)
+    {
+        assert(current_pool() != this and "Must not call parallel_for() from a task on the same pool");
+        if (a_count == 0)
+        {
+            return;
+        }
+
+        // Shared by all helpers, which live on this stack frame until every helper is done.
+        struct job
+        {
+            std::atomic<size_type> next{0};
+            std::mutex mutex{};
+            std::condition_variable done{};
+            size_type running = 0;
+            std::exception_ptr error{};
+        } a_job{};
+
+        auto && run = [&a_job, a_count, &a_function]
+        {
+            for (size_type i = a_job.next++; i < a_count; i = a_job.next++)
+            {
+                try
+                {
+                    a_function(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock{a_job.mutex};
+                    if (not a_job.error)
+                    {
+                        a_job.error = std::current_exception();
+                    }
+                    a_job.next = a_count;
+                }
+            }
+        };
+
+        // Ask workers to help (no more than there are other indices), then help too.
+        size_type const helpers = std::min(size(), a_count - 1);
+        a_job.running = helpers;
+        for (size_type i = 0; i != helpers; ++i)
+        {
+            submit([&a_job, &run]
+            {
+                run();
+                std::lock_guard<std::mutex> lock{a_job.mutex};
+                if (--a_job.running == 0)
+                {
+                    a_job.done.notify_one();
+                }
+            });
+        }
+        thread_pool * const caller_pool = current_pool();
+        current_pool() = this;
+        run();
+        current_pool() = caller_pool;
+
+        std::unique_lock<std::mutex> lock{a_job.mutex};
+        a_job.done.wait(lock, [&a_job] { return a_job.running == 0; });
+        if (a_job.error)
+        {
+            std::rethrow_exception(a_job.error);
+        }
+    }
+
+    // One less than the number of cores, or 0 if unknown.
+    static size_type default_thread_count()
+    {
+        size_type const cores = std::thread::hardware_concurrency();
+        return cores > 0 ? cores - 1 : 0;
+    }
+
+private:
+
+    // Pool whose task is running on this thread, if any, so parallel_for() can detect being called from one of its own tasks.
+    static thread_pool *& current_pool()
+    {
+        thread_local thread_pool * a_pool = nullptr;
+        return a_pool;
+    }
+
+    // Run tasks until stopping and there are no more tasks.
+    void work()
+    {
+        current_pool() = this;
+        for (;;)
+        {
+            std::function<void()> a_task{};
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+                ready_.wait(lock, [this] { return stopping_ or not tasks_.empty(); });
+                if (tasks_.empty())
+                {
+                    return;
+                }
+                a_task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            a_task();
+        }
+    }
+
+    std::mutex mutex_{};
+    std::condition_variable ready_{};
+    std::deque<std::function<void()> > tasks_{};
+    bool stopping_ = false;
+    std::vector<std::thread> workers_{};
+};
+
+}
+
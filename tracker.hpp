@@ -1,9 +1,22 @@
 #pragma once
 
+#include "allocator.hpp"
 #include "find.hpp"
+#include "hook.hpp"
+#include "reserve.hpp"
+#include "span.hpp"
 #include "static_dispatch.hpp"
+#include "tracker_dirty.hpp"
+#include "tracker_link.hpp"
+#include "tracker_stats.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -14,44 +27,96 @@ namespace wade {
 // Aliases for long template names (not part of interface and will be undefined).
 // Container for holding tracked objects is customizable with a vector used by default,
 // which should be efficient if detaching objects is a relatively rare operation (so erase() is not called frequently).
-#define TRACKER_TEMPLATE_DECL template <typename Derived, typename Tracked_T, typename Container_T = std::vector<Tracked_T *> >
-#define TRACKER_TEMPLATE template <typename Derived, typename Tracked_T, typename Container_T>
-#define TRACKER_TYPE tracker<Derived, Tracked_T, Container_T>
+// Allocator for made objects is also customizable with the heap (std::allocator) used by default.
+// Stats of operations are recorded by a stats policy (see tracker_stats.hpp), which records nothing by default.
+// Objects refer to their tracker with a link policy (see tracker_link.hpp), which is a pointer by default.
+// Objects may be marked dirty only with a dirty policy that stores their place in the dirty list (see tracker_dirty.hpp), which objects do not store by default.
+#define TRACKER_TEMPLATE_DECL template <typename Derived, typename Tracked_T, typename Container_T = std::vector<Tracked_T *>, typename Allocator_T = std::allocator<Tracked_T>, typename Stats_T = no_stats, typename Link_T = pointer_link, typename Dirty_T = no_dirty_list>
+#define TRACKER_TEMPLATE template <typename Derived, typename Tracked_T, typename Container_T, typename Allocator_T, typename Stats_T, typename Link_T, typename Dirty_T>
+#define TRACKER_TYPE tracker<Derived, Tracked_T, Container_T, Allocator_T, Stats_T, Link_T, Dirty_T>
+
+// Call a method of the derived class with DISPATCH (i.e., STATIC_DISPATCH), timed by the stats policy (not part of interface and will be undefined).
+#define TRACKER_NOTIFY(DISPATCH, FUNC, ...) \
+    do \
+    { \
+        auto && dispatch_timer = this->start_timer(tracker_operation::dispatch); \
+        (void)dispatch_timer; \
+        DISPATCH(Derived, FUNC, __VA_ARGS__); \
+    } while (false)
 
 // Macro for defining a tracker with a custom container to ensure that the container's template parameter is given correctly. For example:
 //   TRACKER_WITH_CONTAINER(Mytracker, MyClass, std::set)
+// A container may store a hook in each tracked object (see hook.hpp) to avoid searching for objects when detaching them,
+// such as wade::unordered_vector and wade::slot_map, which detach in constant time.
 #define TRACKER_WITH_CONTAINER(TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE) \
     wade::tracker<TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE<TRACKED_TYPE *> >
 
+// Macro for defining a tracker with a custom container and allocator for made objects. For example:
+//   TRACKER_WITH_ALLOCATOR(Mytracker, MyClass, std::vector, wade::pool_allocator)
+// The allocator is rebound to the type of made objects, and may be stateful, such as wade::pool_allocator,
+// which makes objects from a pool owned by the tracker (and by the objects made from it).
+#define TRACKER_WITH_ALLOCATOR(TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE, ALLOCATOR_TYPE) \
+    wade::tracker<TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE<TRACKED_TYPE *>, ALLOCATOR_TYPE<TRACKED_TYPE> >
+
 // Factory that tracks made objects.
-// Use make() to construct and track objects of type Tracked_T. Tracked objects are not owned by the tracker.
+// Use make() to construct and track objects of type Tracked_T. Tracked objects are not owned by the tracker,
+// unless made with make_owned(), which keeps them until destroy_all() or the tracker is destroyed.
 // A tracked object that is deleted will automatically detach itself from its tracker.
 // Access all tracked objects with tracked_objects().
+// Use defer_detach() while iterating over tracked_objects() to safely detach (or delete) objects during iteration.
 //
 // Derive from this class and pass the derived class as the first template parameter (CRTP / static polymorphism).
-// The derived class must define these methods:
+// The derived class may define any of these methods, and methods that are not defined are not called at all (so cost nothing):
 //   void did_make(Tracked_T &); // Called by make() after constructing and attaching an object.
 //   void did_attach(Tracked_T &); // Called by attach() after an object is attached (but not by make()).
 //   void did_detach(Tracked_T &); // Called by detach() after an object is detached.
+// The derived class may also define these methods to be notified once for a range of objects by make_n(), make_each(), attach(first, last), and detach(first, last),
+// which are otherwise notified with the methods above for each object:
+//   void did_make_batch(tracked_span);
+//   void did_attach_batch(tracked_span);
+//   void did_detach_batch(tracked_span);
 TRACKER_TEMPLATE_DECL
 class tracker
+    : private allocator_holder<Allocator_T>
+    , private stats_holder<Stats_T>
+    , private dirty_objects_holder<Tracked_T, Dirty_T>
 {
 public:
 
     using tracked_type = Tracked_T;
+    using hook_type = wade::hook_type<Container_T>;
+    using allocator_type = Allocator_T;
+    using link_type = Link_T;
+    using dirty_type = Dirty_T;
+    using size_type = std::size_t;
+
+    // View of objects given to batch methods of the derived class and to for_each_chunk().
+    using tracked_span = wade::span<tracked_type * const>;
+
+    // Maximum number of objects in each span given to for_each_chunk().
+    static constexpr size_type chunk_size = 256;
 
     // Moveable but not copyable.
-    // Movement is not defaulted as it transfers tracked objects.
+    // Movement is not defaulted as it transfers tracked objects, which takes constant time if the link policy can retarget its link (i.e., wade::stable_link),
+    // and otherwise links each object to the moved tracker (see tracker_link.hpp). The allocator is moved too (so a copy of a pool_allocator shares its pool, but a fixed_allocator's pool is taken from rhs).
     tracker() = default;
     tracker(tracker const &) = delete;
     tracker & operator=(tracker const &) = delete;
     tracker(tracker &&);
     tracker & operator=(tracker &&);
 
+    // Construct with the allocator for made objects, such as a stateful allocator that must be given its pool (i.e., wade::fixed_allocator).
+    explicit tracker(allocator_type const & an_allocator)
+        : allocator_holder<Allocator_T>{an_allocator}
+    {
+    }
+
     // Object being tracked.
     // Detaches itself from its tracker when destroyed.
     class trackable
         : public tracked_type
+        , private hook_holder<hook_type>
+        , private dirty_holder<Dirty_T>
     {
         // Metafunction helper.
         template <bool B, typename T = void>
@@ -67,24 +132,26 @@ public:
         template <typename Arg, typename ...Args, typename = typename
             disable_if<
                 sizeof...(Args) == 0
-                and std::is_same<typename std::remove_reference<Arg>::type, trackable>::value
+                and std::is_same<typename std::decay<Arg>::type, trackable>::value
             >::type
         >
-        trackable(Args && ...args)
-            : tracked_type{std::forward<Args>(args)...}
-            , tracker_{nullptr}
+        trackable(Arg && arg, Args && ...args)
+            : tracked_type{std::forward<Arg>(arg), std::forward<Args>(args)...}
+            , link_{}
         {
         }
 
         // Copying attaches to the same tracker.
         trackable(trackable const & rhs)
             : tracked_type{rhs}
-            , tracker_{nullptr}
+            , hook_holder<hook_type>{}
+            , dirty_holder<Dirty_T>{}
+            , link_{}
         {
-            if (rhs.tracker_)
+            if (rhs.is_attached())
             {
-                // Must initialize this->tracker_ to nullptr since attach() returns early if tracker_ is already assigned.
-                rhs.tracker_->attach(this);
+                // Must initialize this->link_ to a null link since attach() returns early if link_ is already assigned.
+                rhs.linked_tracker()->attach(this);
             }
         }
         trackable & operator=(trackable const & rhs)
@@ -92,12 +159,12 @@ public:
             if (this != &rhs)
             {
                 tracked_type::operator=(rhs);
-                if (tracker_ != rhs.tracker_)
+                if (link_ != rhs.link_)
                 {
                     detach();
-                    if (rhs.tracker_)
+                    if (rhs.is_attached())
                     {
-                        rhs.tracker_->attach(this);
+                        rhs.linked_tracker()->attach(this);
                     }
                 }
             }
@@ -107,13 +174,17 @@ public:
         // Moving transfers the tracker.
         trackable(trackable && rhs)
             : tracked_type{std::move(rhs)}
-            , tracker_{nullptr}
+            , link_{}
         {
-            tracker * tracker = rhs.tracker_;
+            tracker * tracker = rhs.my_tracker();
+            bool const dirty = rhs.is_dirty();
             rhs.detach();
             if (tracker)
             {
-                tracker->attach(this);
+                if (tracker->attach(this) and dirty)
+                {
+                    tracker->mark_dirty(this);
+                }
             }
         }
         trackable & operator=(trackable && rhs)
@@ -121,11 +192,15 @@ public:
             assert(this != &rhs);
             tracked_type::operator=(std::move(rhs));
             detach();
-            tracker * tracker = rhs.tracker_;
+            tracker * tracker = rhs.my_tracker();
+            bool const dirty = rhs.is_dirty();
             rhs.detach();
             if (tracker)
             {
-                tracker->attach(this);
+                if (tracker->attach(this) and dirty)
+                {
+                    tracker->mark_dirty(this);
+                }
             }
             return *this;
         }
@@ -143,7 +218,7 @@ public:
             if (is_attached())
             {
                 // Detaching should succeed since already checked that this is attached.
-                bool const success = tracker_->detach(this);
+                bool const success = my_tracker()->detach(this);
                 assert(success);
                 assert(is_detached());
                 return success;
@@ -152,60 +227,278 @@ public:
         }
 
         // Get this tracker. Returns nullptr if not attached.
-        tracker * my_tracker() { return tracker_; }
-        tracker const * my_tracker() const { return tracker_; }
+        tracker * my_tracker() { return linked_tracker(); }
+        tracker const * my_tracker() const { return linked_tracker(); }
 
         // Whether this object is attached to any tracker or not.
-        bool is_attached() const { return my_tracker() != nullptr; }
+        bool is_attached() const { return static_cast<bool>(link_); }
         bool is_detached() const { return not is_attached(); }
 
+        // Get the data stored in this object by the tracker's container. Only meaningful while attached.
+        hook_type const & my_hook() const { return this->tracker_hook(); }
+
+        // Add this object to its tracker's dirty list, which is drained by tracker::consume_dirty().
+        // Returns true if added, and false if detached or already dirty (so an object is never listed twice).
+        // Requires a dirty policy that is enabled (i.e., wade::dirty_list).
+        bool mark_dirty()
+        {
+            static_assert(Dirty_T::enabled, "Tracker must have a dirty policy that is enabled (i.e., wade::dirty_list) to mark objects dirty");
+            return is_attached() and my_tracker()->mark_dirty(this);
+        }
+
+        // Whether this object is in its tracker's dirty list. Detaching removes an object from the list.
+        // Always false without a dirty policy that is enabled.
+        bool is_dirty() const { return this->tracker_dirty().get() != 0; }
+
     private:
 
         friend class tracker;
 
-        // Non-owning pointer to tracker.
+        // Tracker of this object, or nullptr if not attached.
+        tracker * linked_tracker() const { return static_cast<tracker *>(link_.get()); }
+
+        // Non-owning link to the tracker.
         // Detached by default.
-        tracker * tracker_ = nullptr;
+        Link_T link_{};
     };
 
-    using trackable_ptr = std::unique_ptr<trackable>;
+    // Made objects are deleted with the tracker's allocator, unless it is the default allocator, which just uses delete.
+    using trackable_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<trackable>;
+    using trackable_deleter = typename std::conditional<
+        std::is_same<trackable_allocator_type, std::allocator<trackable> >::value,
+        std::default_delete<trackable>,
+        allocator_deleter<trackable_allocator_type>
+    >::type;
+    using trackable_ptr = std::unique_ptr<trackable, trackable_deleter>;
+
+    // Get the allocator for made objects.
+    allocator_type get_allocator() const { return this->tracker_allocator(); }
+
+    // Get the stats recorded so far by the stats policy.
+    using stats_type = typename Stats_T::snapshot_type;
+    stats_type stats() const { return this->stats_policy().snapshot(); }
 
     // Make an attached object.
     // Calls did_make() after constructing and attaching.
+    // Returns nullptr if the tracker is full (see is_full()).
     template <typename ...Args>
     trackable_ptr make(Args && ...args);
 
     // Attach an object.
     // Calls did_attach() if successful.
-    // Returns true if successful and false otherwise.
-    bool attach(trackable_ptr &);
+    // Returns true if successful and false otherwise (including if the container is full).
+    // Accepts any unique_ptr to a trackable, such as trackable_ptr or one using the default deleter.
+    template <typename Deleter_T>
+    bool attach(std::unique_ptr<trackable, Deleter_T> &);
     bool attach(trackable *);
 
     // Detach an object.
     // Detaching does not delete an object, but deleting does detach it.
     // Calls did_detach() if successful.
     // Returns true if successful and false otherwise.
-    bool detach(trackable_ptr &);
+    template <typename Deleter_T>
+    bool detach(std::unique_ptr<trackable, Deleter_T> &);
     bool detach(trackable *);
 
+    // Make a number of attached objects, each constructed with copies of the same arguments.
+    // Reserves space for all objects at once, and calls did_make_batch() (or did_make() for each object) after all are made.
+    // Makes fewer objects if the tracker becomes full (see is_full()).
+    template <typename ...Args>
+    std::vector<trackable_ptr> make_n(size_type, Args const & ...);
+
+    // Make an attached object copied from each value of a range of Tracked_T, such as the objects loaded by wade::load().
+    // Calls did_make_batch() once for all objects, or did_make() for each object if not defined.
+    // Makes objects for only the first values if the tracker becomes full (see is_full()).
+    template <typename Iter>
+    std::vector<trackable_ptr> make_each(Iter, Iter);
+
+    // Attach a range of objects, given by iterators to trackable pointers or unique_ptrs.
+    // Calls did_attach_batch() (or did_attach() for each object) after all are attached.
+    // Stops attaching once the container is full.
+    // Returns the number of objects attached.
+    template <typename Iter>
+    size_type attach(Iter, Iter);
+
+    // Detach a range of objects, given by iterators to trackable pointers or unique_ptrs.
+    // Erases all objects from a container whose objects can be replaced in place (i.e., std::vector) in a single pass,
+    // and calls did_detach_batch() (or did_detach() for each object) after all are detached.
+    // Returns the number of objects detached.
+    template <typename Iter>
+    size_type detach(Iter, Iter);
+
     // Detach all objects.
     void detach_all();
 
+    // Move the objects of another tracker for which a predicate (taking a Tracked_T &) is true to this tracker, such as to balance objects between shards.
+    // Finds the objects in a single pass, then detaches them all (see detach(first, last)) before attaching them all (see attach(first, last)),
+    // so each tracker is notified once with did_detach_batch() or did_attach_batch() (or did_detach() or did_attach() for each object).
+    // Moved objects are no longer dirty, and any that do not fit in this tracker are attached back to the source.
+    // Returns the number of objects moved.
+    template <typename Predicate>
+    size_type migrate_from(tracker &, Predicate &&);
+
+    // Make an attached object that is owned by the tracker, which returns a pointer to it instead of a trackable_ptr.
+    // Calls did_make() after constructing and attaching.
+    // Returns nullptr if the tracker is full (see is_full()), without allocating.
+    // Owned objects may be detached (or attached to another tracker) like any other, but are only deleted by destroy_all() or the tracker's destructor.
+    template <typename ...Args>
+    trackable * make_owned(Args && ...);
+
+    // Detach all objects, then delete all owned objects.
+    // Faster than deleting each object, since owned objects are deleted after all are detached in a single pass,
+    // so deleting them never searches the container.
+    void destroy_all();
+
+    // Number of objects owned by the tracker, whether attached or not.
+    size_type owned_size() const;
+
+    // Reserve room for a number of attached objects (for containers that can reserve) and dirty objects,
+    // and acquire the link given to objects (which may allocate, i.e., wade::stable_link), so attaching and marking up to that many objects does not allocate.
+    // Reserves the dirty list twice over (if objects may be marked dirty), so it has room for the nullptr left by detaching dirty objects until they are compacted (see mark_dirty()).
+    void reserve(size_type);
+
+    // Whether no more objects can be made because the container or allocator has a fixed capacity that is full (i.e., wade::fixed_tracker).
+    // Trackers with other containers and allocators are never full.
+    bool is_full() const { return wade::is_full(tracked_objects_) or wade::is_full(this->tracker_allocator()); }
+
+    // Call a function with a reference to each object marked dirty (see trackable::mark_dirty()) in the order marked, and mark it clean.
+    // Each object is marked clean before the function is called, so the function may mark it dirty again for the next call,
+    // and may detach or delete any object.
+    // Returns the number of objects consumed.
+    template <typename Function>
+    size_type consume_dirty(Function &&);
+
+    // Number of objects marked dirty, plus any that were detached since last consumed (until the list is compacted).
+    size_type dirty_size() const { return this->tracker_dirty_objects().size(); }
+
+    // Immutable view of the objects that were attached when it was published, shared by every reader that gets it.
+    using snapshot_ptr = std::shared_ptr<std::vector<tracked_type *> const>;
+
+    // Publish a snapshot of the attached objects for readers on other threads, if any objects were attached or detached since the last one.
+    // Copies the objects once for each change rather than for each reader, so publish where the objects are consistent, such as once per frame.
+    // Must be called by the thread that modifies the tracker. Objects detached while deferring are not included.
+    void publish();
+
+    // Get the last published snapshot in constant time, or nullptr if none has been published.
+    // Safe to call from any thread while the tracker is modified, since readers and publish() only share the snapshot pointer itself.
+    // Snapshots do not keep objects alive, so readers must only dereference objects that are not deleted until they finish,
+    // such as by deleting objects only between frames.
+    snapshot_ptr snapshot() const;
+
+    // Guard that defers erasing detached objects from the container until it is destroyed.
+    // Made by defer_detach(). Moveable but not copyable.
+    class deferral
+    {
+    public:
+
+        deferral(deferral const &) = delete;
+        deferral & operator=(deferral const &) = delete;
+        deferral(deferral && rhs)
+            : tracker_{rhs.tracker_}
+        {
+            rhs.tracker_ = nullptr;
+        }
+        deferral & operator=(deferral &&) = delete;
+
+        // Ending the outermost deferral erases all detached objects from the container in a single pass.
+        ~deferral()
+        {
+            if (tracker_)
+            {
+                tracker_->end_deferral();
+            }
+        }
+
+    private:
+
+        friend class tracker;
+
+        explicit deferral(tracker * a_tracker)
+            : tracker_{a_tracker}
+        {
+        }
+
+        tracker * tracker_ = nullptr;
+    };
+
+    // Defer erasing detached objects from the container while the returned guard lives, which may be nested. For example:
+    //   auto && deferral = tracker.defer_detach();
+    //   for (auto && a_tracked : tracker.tracked_objects()) { if (a_tracked and is_dead(*a_tracked)) { destroy(a_tracked); } }
+    // Detaching an object replaces it with nullptr in the container, so iteration is never invalidated by detaching
+    // (though attaching may still invalidate it depending on container_type's behavior for insertion).
+    // Only containers whose objects can be replaced in place or with hooks that support it (i.e., std::vector and wade::unordered_vector, but not std::set, wade::flat_set, or wade::intrusive_list) can defer.
+    deferral defer_detach();
+
+    // Whether detaching is currently deferred.
+    bool is_deferring() const { return deferral_depth_ != 0; }
+
     // Whether the object is attached to this tracker or not.
-    bool is_attached(trackable_ptr const & a_trackable) const { return is_attached(a_trackable.get()); }
-    bool is_attached(trackable const * a_trackable) const { return a_trackable and (a_trackable->tracker_ == this); }
-    bool is_detached(trackable_ptr const & a_trackable) const { return not is_attached(a_trackable); }
+    template <typename Deleter_T>
+    bool is_attached(std::unique_ptr<trackable, Deleter_T> const & a_trackable) const { return is_attached(a_trackable.get()); }
+    bool is_attached(trackable const * a_trackable) const { return a_trackable and a_trackable->link_ and (a_trackable->link_ == link_); }
+    template <typename Deleter_T>
+    bool is_detached(std::unique_ptr<trackable, Deleter_T> const & a_trackable) const { return not is_attached(a_trackable); }
     bool is_detached(trackable const * a_trackable) const { return not is_attached(a_trackable); }
 
+    // Call a function with a reference to each attached object, skipping any nullptr left by deferred detaching.
+    // The function must not attach or detach objects unless detaching is deferred (see defer_detach()).
+    template <typename Function>
+    void for_each(Function &&);
+
+    // Call a function with spans of pointers to consecutive chunks of attached objects, so it can loop over each chunk
+    // with a known size instead of through container iterators, which lets the compiler unroll and vectorize the loop.
+    // Spans point directly into containers with contiguous data() (i.e., std::vector, wade::unordered_vector, and wade::slot_map),
+    // and objects are copied into a buffer for each chunk otherwise.
+    // Spans may contain nullptr while detaching is deferred. The function must follow the same rules as for for_each().
+    template <typename Function>
+    void for_each_chunk(Function &&);
+
+    // Call a function for each attached object or chunk of objects, like the overloads above, but in parallel with an executor
+    // (such as wade::thread_pool), which splits the container into chunks of chunk_size objects. For example:
+    //   wade::thread_pool pool{};
+    //   tracker.for_each(pool, [](MyClass & a_tracked) { a_tracked.update(); });
+    // Requires a container with random access (i.e., std::vector, wade::unordered_vector, and wade::slot_map, but not std::set).
+    // The function may be called concurrently for different objects, and must not attach or detach any object.
+    // Must not be called from a task running on the same executor, which deadlocks once all its workers wait on themselves (see thread_pool::parallel_for()).
+    template <typename Executor, typename Function>
+    void for_each(Executor &, Function &&);
+    template <typename Executor, typename Function>
+    void for_each_chunk(Executor &, Function &&);
+
     // Get all attached objects.
     // Calling detach() on an object may invalidate this container during iteration
-    // depending on container_type's behavior for erase().
+    // depending on container_type's behavior for erase(), unless detaching is deferred (see defer_detach()),
+    // in which case detached objects are left as nullptr until the deferral ends.
     using container_type = Container_T;
     container_type const & tracked_objects() const { return tracked_objects_; }
 
+    // Find an attached object by key, for containers that index objects by key (i.e., wade::keyed_vector).
+    // Returns nullptr if no attached object has the key.
+    template <typename Key, typename Container = Container_T>
+    auto find_by_key(Key const & a_key) const -> decltype(std::declval<Container const &>().find_by_key(a_key), static_cast<trackable *>(nullptr))
+    {
+        return static_cast<trackable *>(tracked_objects_.find_by_key(a_key));
+    }
+
+    // Get the attached objects with a tag, for containers that partition objects by tag (i.e., wade::partitioned_vector).
+    template <typename Container = Container_T>
+    auto partition(size_type a_partition) const -> decltype(std::declval<Container const &>().partition(a_partition), tracked_span{})
+    {
+        auto && objects = tracked_objects_.partition(a_partition);
+        return tracked_span{objects.data(), objects.size()};
+    }
+
+    // Move an attached object to the partition of its tag after its tag has changed.
+    template <typename Container = Container_T>
+    auto repartition(trackable & a_trackable) -> decltype(std::declval<Container const &>().partition_count(), void())
+    {
+        assert(a_trackable.my_tracker() == this);
+        tracked_objects_.repartition(&a_trackable, hook_of{});
+    }
+
 protected:
 
-    // Destructor detaches (but does not delete) all objects.
+    // Destructor detaches all objects, and deletes only owned objects.
     // Protected destructor since should not have a tracker base class pointer to a derived class instance.
     ~tracker();
 
@@ -215,21 +508,156 @@ private:
     void connect(trackable *);
     void disconnect(trackable *);
 
+    // Time an operation with the stats policy until the returned timer is destroyed.
+    auto start_timer(tracker_operation an_operation) -> decltype(std::declval<Stats_T &>().start(an_operation)) { return this->stats_policy().start(an_operation); }
+
+    // Get the link given to attached objects, which is acquired when first needed (so a tracker that is never attached to need not acquire one).
+    Link_T const & link();
+
+    // Link each attached object to this tracker after it has moved, either by retargeting its link in constant time, or by relinking each object.
+    DEFINE_HAS_MEMBER_FUNCTION(has_retarget, retarget);
+    using is_retargetable = has_retarget<Link_T, Link_T, void *>;
+    void relink(tracker &, std::true_type);
+    void relink(tracker &, std::false_type);
+
+    // Add an attached object to the dirty list, or remove a detached object from it (see dirty_objects).
+    bool mark_dirty(trackable * a_trackable) { return this->tracker_dirty_objects().mark(a_trackable, dirty_of{}); }
+    void clean(trackable * a_trackable) { this->tracker_dirty_objects().clean(a_trackable, dirty_of{}); }
+    void clean_all() { this->tracker_dirty_objects().clean_all(dirty_of{}); }
+
+    // Note that objects were attached or detached, so the last published snapshot is no longer current.
+    void did_change();
+
+    // Whether objects can be replaced in place through the container's random access iterators (i.e., std::vector but not std::set or wade::flat_set).
+    using is_assignable_in_place = std::integral_constant<bool,
+        std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<typename Container_T::iterator>::iterator_category>::value
+        and std::is_assignable<typename std::iterator_traits<typename Container_T::iterator>::reference, tracked_type *>::value
+    >;
+
+    // Erase an object from the container now, or replace it with nullptr if deferring.
+    // Containers that cannot defer are rejected by defer_detach(), so they always erase now.
+    // Containers with a hook can defer only if they define erase_deferred() (see hook.hpp), and others only if objects can be replaced in place.
+    DEFINE_HAS_MEMBER_FUNCTION(has_erase_deferred, erase_deferred);
+    using is_deferrable = std::integral_constant<bool, has_hook<Container_T>::value
+        ? has_erase_deferred<Container_T, tracked_type * const &, hook_type & (*)(tracked_type *)>::value
+        : is_assignable_in_place::value
+    >;
+    void erase(trackable *, std::true_type);
+    void erase(trackable *, std::false_type);
+
+    // Called by the destructor of a deferral.
+    void end_deferral();
+
+    // Visit chunks of objects in place for containers with contiguous data(), or by copying them otherwise.
+    DEFINE_HAS_MEMBER_FUNCTION(has_data, data);
+    template <typename Function>
+    void for_each_chunk(Function &&, std::true_type);
+    template <typename Function>
+    void for_each_chunk(Function &&, std::false_type);
+
+    // Whether the container can be split into chunks for parallel iteration.
+    using is_random_access = std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<typename Container_T::const_iterator>::iterator_category>;
+
+    // Construct an object with the allocator, or just with new for the default allocator.
+    using is_default_deleter = std::is_same<trackable_deleter, std::default_delete<trackable> >;
+    template <typename ...Args>
+    trackable_ptr allocate(std::true_type, Args && ...);
+    template <typename ...Args>
+    trackable_ptr allocate(std::false_type, Args && ...);
+
+    // Get the object that a range element refers to.
+    static trackable * get(trackable * a_trackable) { return a_trackable; }
+    template <typename Deleter_T>
+    static trackable * get(std::unique_ptr<trackable, Deleter_T> const & a_trackable) { return a_trackable.get(); }
+
+    // Call the derived class's methods only if defined.
+    DEFINE_OPTIONAL_DISPATCH(did_make);
+    DEFINE_OPTIONAL_DISPATCH(did_attach);
+    DEFINE_OPTIONAL_DISPATCH(did_detach);
+    DEFINE_HAS_MEMBER_FUNCTION(has_did_detach, did_detach);
+
+    // Detach all objects, notifying each one only if the derived class defines did_detach().
+    void detach_all(std::true_type);
+    void detach_all(std::false_type);
+
+    // Detach all objects while deferring, either by replacing each with nullptr in place in a single pass (for containers without hooks, which
+    // would otherwise be searched for each object), or by erasing each with its hook.
+    void detach_all_deferred(std::true_type);
+    void detach_all_deferred(std::false_type);
+
+    // Whether the derived class defines the optional batch methods.
+    DEFINE_HAS_MEMBER_FUNCTION(has_did_make_batch, did_make_batch);
+    DEFINE_HAS_MEMBER_FUNCTION(has_did_attach_batch, did_attach_batch);
+    DEFINE_HAS_MEMBER_FUNCTION(has_did_detach_batch, did_detach_batch);
+
+    // Notify the derived class of a range of objects, either all at once or for each object.
+    void did_make_all(tracked_span, std::true_type);
+    void did_make_all(tracked_span, std::false_type);
+    void did_attach_all(tracked_span, std::true_type);
+    void did_attach_all(tracked_span, std::false_type);
+    void did_detach_all(tracked_span, std::true_type);
+    void did_detach_all(tracked_span, std::false_type);
+
+    // Disconnect a range of objects by compacting the container in one pass, or by erasing each object.
+    // Compacting is only possible for containers without hooks whose objects can be replaced in place.
+    using is_compactable = std::integral_constant<bool, not has_hook<Container_T>::value and is_assignable_in_place::value>;
+    template <typename Iter>
+    void disconnect(Iter, Iter, std::vector<tracked_type *> &, std::true_type);
+    template <typename Iter>
+    void disconnect(Iter, Iter, std::vector<tracked_type *> &, std::false_type);
+
+    // Accessor given to containers to find the hook of a tracked object.
+    struct hook_of
+    {
+        hook_type & operator()(tracked_type * a_tracked) const { return static_cast<trackable *>(a_tracked)->tracker_hook(); }
+    };
+
+    // Accessor given to the dirty list to find the dirty policy of a tracked object.
+    struct dirty_of
+    {
+        Dirty_T & operator()(tracked_type * a_tracked) const { return static_cast<trackable *>(a_tracked)->tracker_dirty(); }
+    };
+
+    // State of features that most trackers do not use, which is allocated once first used (by make_owned() or publish()),
+    // so other trackers neither store nor allocate it.
+    struct extension
+    {
+        std::vector<trackable_ptr> owned{};
+
+        // Last published snapshot, and whether it still has the attached objects.
+        // Note: only accessed with atomic functions since readers may get it while it is published.
+        snapshot_ptr published{};
+        bool is_published_current = false;
+    };
+
+    // Get the extension, making it if needed.
+    extension & extend();
+
     container_type tracked_objects_{};
+    Link_T link_{};
+
+    // Note: atomic since readers get the snapshot through it, and never deleted or replaced until the tracker is destroyed
+    // (moving swaps extensions instead), so readers never see it deleted.
+    std::atomic<extension *> extension_{nullptr};
+
+    std::uint32_t deferral_depth_ = 0;
+    std::uint32_t deferred_count_ = 0;
 };
 
+TRACKER_TEMPLATE
+constexpr typename TRACKER_TYPE::size_type TRACKER_TYPE::chunk_size;
+
 TRACKER_TEMPLATE
 TRACKER_TYPE::
 tracker(tracker && rhs)
-    : tracked_objects_{std::move(rhs.tracked_objects_)}
+    : allocator_holder<Allocator_T>{std::move(static_cast<allocator_holder<Allocator_T> &>(rhs))}
+    , dirty_objects_holder<Tracked_T, Dirty_T>{std::move(static_cast<dirty_objects_holder<Tracked_T, Dirty_T> &>(rhs))}
+    , tracked_objects_{std::move(rhs.tracked_objects_)}
+    , extension_{rhs.extension_.exchange(nullptr)}
 {
-    // Attach new objects.
-    for (auto && a_trackable : tracked_objects_)
-    {
-        // Note: static_cast required because container is declared to hold Tracked_T types,
-        // while we make and insert derived trackable types.
-        static_cast<trackable *>(a_trackable)->tracker_ = this;
-    }
+    // Attach new objects, which leaves the old tracker to acquire a new link if it attaches again (unless it keeps its own).
+    assert(not rhs.is_deferring());
+    relink(rhs, is_retargetable{});
 }
 
 TRACKER_TEMPLATE
@@ -239,12 +667,22 @@ operator=(tracker && rhs)
 {
     // Detach all old objects and attach new objects.
     assert(this != &rhs);
-    detach_all();
+    assert(not is_deferring() and not rhs.is_deferring());
+    destroy_all();
+    allocator_holder<Allocator_T>::operator=(std::move(static_cast<allocator_holder<Allocator_T> &>(rhs)));
+    dirty_objects_holder<Tracked_T, Dirty_T>::operator=(std::move(static_cast<dirty_objects_holder<Tracked_T, Dirty_T> &>(rhs)));
     tracked_objects_ = std::move(rhs.tracked_objects_);
-    for (auto && a_trackable : tracked_objects_)
+
+    // Note: the old extension has no owned objects after destroy_all(), and is given to the old tracker with no snapshot,
+    // so readers that still see it never see it deleted.
+    extension * const old_extension = extension_.exchange(rhs.extension_.load());
+    rhs.extension_.store(old_extension);
+    if (old_extension)
     {
-        static_cast<trackable *>(a_trackable)->tracker_ = this;
+        std::atomic_store(&old_extension->published, snapshot_ptr{});
+        old_extension->is_published_current = false;
     }
+    relink(rhs, is_retargetable{});
     return *this;
 }
 
@@ -252,7 +690,44 @@ TRACKER_TEMPLATE
 TRACKER_TYPE::
 ~tracker()
 {
-    detach_all();
+    // Note: a deferral must not outlive its tracker.
+    assert(not is_deferring());
+    destroy_all();
+    Link_T::release(link_);
+    delete extension_.load();
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+relink(tracker & rhs, std::true_type)
+{
+    // Take the link of the old tracker, which its objects keep, and give it this tracker's link (if any).
+    // Note: no objects have this tracker's link after destroy_all(), so it can be given to the old tracker.
+    std::swap(link_, rhs.link_);
+    if (link_)
+    {
+        Link_T::retarget(link_, this);
+    }
+    if (rhs.link_)
+    {
+        Link_T::retarget(rhs.link_, &rhs);
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+relink(tracker &, std::false_type)
+{
+    // Note: the old tracker keeps its own link, which no longer has any objects.
+    for (auto && a_tracked : tracked_objects_)
+    {
+        if (a_tracked)
+        {
+            static_cast<trackable *>(a_tracked)->link_ = link();
+        }
+    }
 }
 
 TRACKER_TEMPLATE
@@ -262,16 +737,54 @@ TRACKER_TYPE::
 make(Args && ...args)
 {
     // Make, attach, and notify.
-    auto && a_trackable = std::make_unique<trackable>(std::forward<Args>(args)...);
+    auto && a_timer = start_timer(tracker_operation::make);
+    (void)a_timer;
+    if (is_full())
+    {
+        return trackable_ptr{};
+    }
+    auto && a_trackable = allocate(is_default_deleter{}, std::forward<Args>(args)...);
     connect(a_trackable.get());
-    STATIC_DISPATCH(Derived, did_make, *a_trackable);
+    TRACKER_NOTIFY(OPTIONAL_STATIC_DISPATCH, did_make, *a_trackable);
     return std::move(a_trackable);
 }
 
 TRACKER_TEMPLATE
+template <typename ...Args>
+typename TRACKER_TYPE::trackable_ptr
+TRACKER_TYPE::
+allocate(std::true_type, Args && ...args)
+{
+    return std::make_unique<trackable>(std::forward<Args>(args)...);
+}
+
+TRACKER_TEMPLATE
+template <typename ...Args>
+typename TRACKER_TYPE::trackable_ptr
+TRACKER_TYPE::
+allocate(std::false_type, Args && ...args)
+{
+    // Deallocate if constructing throws since the deleter only takes ownership of a constructed object.
+    using traits = std::allocator_traits<trackable_allocator_type>;
+    trackable_allocator_type an_allocator{this->tracker_allocator()};
+    trackable * a_trackable = traits::allocate(an_allocator, 1);
+    try
+    {
+        traits::construct(an_allocator, a_trackable, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        traits::deallocate(an_allocator, a_trackable, 1);
+        throw;
+    }
+    return trackable_ptr{a_trackable, trackable_deleter{an_allocator}};
+}
+
+TRACKER_TEMPLATE
+template <typename Deleter_T>
 bool
 TRACKER_TYPE::
-attach(trackable_ptr & a_trackable)
+attach(std::unique_ptr<trackable, Deleter_T> & a_trackable)
 {
     return attach(a_trackable.get());
 }
@@ -281,8 +794,8 @@ bool
 TRACKER_TYPE::
 attach(trackable * a_trackable)
 {
-    // Do nothing if already attached to this.
-    if (not a_trackable or is_attached(a_trackable))
+    // Do nothing if already attached to this, or if there is no room.
+    if (not a_trackable or is_attached(a_trackable) or wade::is_full(tracked_objects_))
     {
         return false;
     }
@@ -291,14 +804,15 @@ attach(trackable * a_trackable)
     a_trackable->detach();
 
     connect(a_trackable);
-    STATIC_DISPATCH(Derived, did_attach, *a_trackable);
+    TRACKER_NOTIFY(OPTIONAL_STATIC_DISPATCH, did_attach, *a_trackable);
     return true;
 }
 
 TRACKER_TEMPLATE
+template <typename Deleter_T>
 bool
 TRACKER_TYPE::
-detach(trackable_ptr & a_trackable)
+detach(std::unique_ptr<trackable, Deleter_T> & a_trackable)
 {
     return detach(a_trackable.get());
 }
@@ -315,36 +829,385 @@ detach(trackable * a_trackable)
     }
 
     disconnect(a_trackable);
-    STATIC_DISPATCH(Derived, did_detach, *a_trackable);
+    TRACKER_NOTIFY(OPTIONAL_STATIC_DISPATCH, did_detach, *a_trackable);
     return true;
 }
 
+TRACKER_TEMPLATE
+template <typename ...Args>
+std::vector<typename TRACKER_TYPE::trackable_ptr>
+TRACKER_TYPE::
+make_n(size_type a_count, Args const & ...args)
+{
+    // Make and attach all, then notify.
+    std::vector<trackable_ptr> made{};
+    made.reserve(a_count);
+    wade::reserve(tracked_objects_, tracked_objects_.size() + a_count);
+    std::vector<tracked_type *> objects{};
+    objects.reserve(a_count);
+    for (size_type i = 0; i != a_count and not is_full(); ++i)
+    {
+        made.push_back(allocate(is_default_deleter{}, args...));
+        connect(made.back().get());
+        objects.push_back(made.back().get());
+    }
+    did_make_all(objects, has_did_make_batch<Derived, tracked_span>{});
+    return made;
+}
+
+TRACKER_TEMPLATE
+template <typename Iter>
+std::vector<typename TRACKER_TYPE::trackable_ptr>
+TRACKER_TYPE::
+make_each(Iter a_first, Iter a_last)
+{
+    // Make and attach all, then notify.
+    auto const count = static_cast<size_type>(std::distance(a_first, a_last));
+    std::vector<trackable_ptr> made{};
+    made.reserve(count);
+    wade::reserve(tracked_objects_, tracked_objects_.size() + count);
+    std::vector<tracked_type *> objects{};
+    objects.reserve(count);
+    for (; a_first != a_last and not is_full(); ++a_first)
+    {
+        made.push_back(allocate(is_default_deleter{}, *a_first));
+        connect(made.back().get());
+        objects.push_back(made.back().get());
+    }
+    did_make_all(objects, has_did_make_batch<Derived, tracked_span>{});
+    return made;
+}
+
+TRACKER_TEMPLATE
+template <typename Iter>
+typename TRACKER_TYPE::size_type
+TRACKER_TYPE::
+attach(Iter a_first, Iter a_last)
+{
+    // Only reserve for ranges that can be measured without consuming them.
+    using category = typename std::iterator_traits<Iter>::iterator_category;
+    std::vector<tracked_type *> attached{};
+    if (std::is_base_of<std::forward_iterator_tag, category>::value)
+    {
+        auto const count = static_cast<size_type>(std::distance(a_first, a_last));
+        attached.reserve(count);
+        wade::reserve(tracked_objects_, tracked_objects_.size() + count);
+    }
+
+    // Attach all, then notify.
+    for (; a_first != a_last; ++a_first)
+    {
+        trackable * a_trackable = get(*a_first);
+        if (not a_trackable or is_attached(a_trackable))
+        {
+            continue;
+        }
+        if (wade::is_full(tracked_objects_))
+        {
+            break;
+        }
+        a_trackable->detach();
+        connect(a_trackable);
+        attached.push_back(a_trackable);
+    }
+    did_attach_all(attached, has_did_attach_batch<Derived, tracked_span>{});
+    return attached.size();
+}
+
+TRACKER_TEMPLATE
+template <typename Iter>
+typename TRACKER_TYPE::size_type
+TRACKER_TYPE::
+detach(Iter a_first, Iter a_last)
+{
+    // Detach all, then notify.
+    // Note: compacting would move objects that may be being iterated over, so erase each object if deferring.
+    std::vector<tracked_type *> detached{};
+    if (is_deferring())
+    {
+        disconnect(a_first, a_last, detached, std::false_type{});
+    }
+    else
+    {
+        disconnect(a_first, a_last, detached, is_compactable{});
+    }
+    did_detach_all(detached, has_did_detach_batch<Derived, tracked_span>{});
+    return detached.size();
+}
+
+TRACKER_TEMPLATE
+template <typename Predicate>
+typename TRACKER_TYPE::size_type
+TRACKER_TYPE::
+migrate_from(tracker & a_source, Predicate && a_predicate)
+{
+    assert(&a_source != this);
+    std::vector<trackable *> migrated{};
+    for (auto && a_tracked : a_source.tracked_objects_)
+    {
+        if (a_tracked and a_predicate(*a_tracked))
+        {
+            migrated.push_back(static_cast<trackable *>(a_tracked));
+        }
+    }
+    if (migrated.empty())
+    {
+        return 0;
+    }
+
+    // Note: attaching would detach each object from the source anyway, but detaching all first erases them in one pass.
+    a_source.detach(std::begin(migrated), std::end(migrated));
+    size_type const count = attach(std::begin(migrated), std::end(migrated));
+    if (count != migrated.size())
+    {
+        // Attaching stops at the first object that does not fit, and the source has room since the objects just left it.
+        a_source.attach(std::begin(migrated) + static_cast<std::ptrdiff_t>(count), std::end(migrated));
+    }
+    return count;
+}
+
 TRACKER_TEMPLATE
 void
 TRACKER_TYPE::
 detach_all()
+{
+    did_change();
+
+    // Detach each object if deferring, leaving nullptr in its place, as the container may be being iterated over.
+    if (is_deferring())
+    {
+        detach_all_deferred(is_compactable{});
+        return;
+    }
+
+    clean_all();
+    detach_all(has_did_detach<Derived, tracked_type &>{});
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+detach_all_deferred(std::true_type)
+{
+    // Note: each object is replaced before it is notified, so did_detach() may detach (or delete) any object.
+    for (auto && a_tracked : tracked_objects_)
+    {
+        if (a_tracked)
+        {
+            auto && a_timer = start_timer(tracker_operation::disconnect);
+            (void)a_timer;
+            trackable * a_trackable = static_cast<trackable *>(a_tracked);
+            a_tracked = nullptr;
+            ++deferred_count_;
+            clean(a_trackable);
+            a_trackable->link_ = Link_T{};
+            TRACKER_NOTIFY(OPTIONAL_STATIC_DISPATCH, did_detach, *a_trackable);
+        }
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+detach_all_deferred(std::false_type)
+{
+    for (auto && a_tracked : tracked_objects_)
+    {
+        if (a_tracked)
+        {
+            trackable * a_trackable = static_cast<trackable *>(a_tracked);
+            disconnect(a_trackable);
+            TRACKER_NOTIFY(OPTIONAL_STATIC_DISPATCH, did_detach, *a_trackable);
+        }
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+detach_all(std::true_type)
 {
     // Detach all objects.
     // Note: not calling detach() since it will erase from the container, which may invalidate loop iteration.
     for (auto && a_trackable : tracked_objects_)
     {
         // Note: did_detach will be called but tracked_objects_.size() will not have changed yet.
-        static_cast<trackable *>(a_trackable)->tracker_ = nullptr;
-        STATIC_DISPATCH(Derived, did_detach, *a_trackable);
+        static_cast<trackable *>(a_trackable)->link_ = Link_T{};
+        TRACKER_NOTIFY(STATIC_DISPATCH, did_detach, *a_trackable);
     }
     tracked_objects_.clear();
 }
 
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+detach_all(std::false_type)
+{
+    // Only reset each object's tracker (which objects still need since they outlive being tracked), then clear without notifying.
+    for (auto && a_trackable : tracked_objects_)
+    {
+        static_cast<trackable *>(a_trackable)->link_ = Link_T{};
+    }
+    tracked_objects_.clear();
+}
+
+TRACKER_TEMPLATE
+template <typename ...Args>
+typename TRACKER_TYPE::trackable *
+TRACKER_TYPE::
+make_owned(Args && ...args)
+{
+    // Own before notifying, so the object is not leaked if did_make() throws.
+    auto && a_timer = start_timer(tracker_operation::make);
+    (void)a_timer;
+    if (is_full())
+    {
+        return nullptr;
+    }
+    auto && owned = extend().owned;
+    owned.push_back(allocate(is_default_deleter{}, std::forward<Args>(args)...));
+    trackable * a_trackable = owned.back().get();
+    connect(a_trackable);
+    TRACKER_NOTIFY(OPTIONAL_STATIC_DISPATCH, did_make, *a_trackable);
+    return a_trackable;
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+destroy_all()
+{
+    // Note: owned objects that are attached to another tracker still detach from it when deleted.
+    assert(not is_deferring());
+    detach_all();
+    if (extension * an_extension = extension_.load(std::memory_order_relaxed))
+    {
+        an_extension->owned.clear();
+    }
+}
+
+TRACKER_TEMPLATE
+typename TRACKER_TYPE::size_type
+TRACKER_TYPE::
+owned_size() const
+{
+    extension const * an_extension = extension_.load(std::memory_order_relaxed);
+    return an_extension ? an_extension->owned.size() : 0;
+}
+
+TRACKER_TEMPLATE
+template <typename Function>
+void
+TRACKER_TYPE::
+for_each(Function && a_function)
+{
+    for (auto && a_tracked : tracked_objects_)
+    {
+        if (a_tracked)
+        {
+            a_function(*a_tracked);
+        }
+    }
+}
+
+TRACKER_TEMPLATE
+template <typename Function>
+void
+TRACKER_TYPE::
+for_each_chunk(Function && a_function)
+{
+    for_each_chunk(std::forward<Function>(a_function), has_data<Container_T const>{});
+}
+
+TRACKER_TEMPLATE
+template <typename Function>
+void
+TRACKER_TYPE::
+for_each_chunk(Function && a_function, std::true_type)
+{
+    // Note: the span is made once before calling the function, so the function must not change the container (unless deferring).
+    tracked_span const objects{tracked_objects_.data(), tracked_objects_.size()};
+    for (size_type first = 0; first < objects.size(); first += chunk_size)
+    {
+        a_function(objects.subspan(first, std::min(chunk_size, objects.size() - first)));
+    }
+}
+
+TRACKER_TEMPLATE
+template <typename Function>
+void
+TRACKER_TYPE::
+for_each_chunk(Function && a_function, std::false_type)
+{
+    std::array<tracked_type *, chunk_size> chunk{};
+    size_type count = 0;
+    for (auto && a_tracked : tracked_objects_)
+    {
+        chunk[count++] = a_tracked;
+        if (count == chunk_size)
+        {
+            a_function(tracked_span{chunk.data(), count});
+            count = 0;
+        }
+    }
+    if (count != 0)
+    {
+        a_function(tracked_span{chunk.data(), count});
+    }
+}
+
+TRACKER_TEMPLATE
+template <typename Executor, typename Function>
+void
+TRACKER_TYPE::
+for_each(Executor & a_executor, Function && a_function)
+{
+    // Visit each chunk's objects in place with an iterator to the start of the chunk.
+    static_assert(is_random_access::value, "Container must have random access to iterate in parallel");
+    auto const first = std::begin(tracked_objects_);
+    size_type const size = tracked_objects_.size();
+    a_executor.parallel_for((size + chunk_size - 1) / chunk_size, [&first, size, &a_function](size_type a_chunk)
+    {
+        size_type const offset = a_chunk * chunk_size;
+        auto const chunk = first + static_cast<std::ptrdiff_t>(offset);
+        for (size_type i = 0, count = std::min(chunk_size, size - offset); i != count; ++i)
+        {
+            if (auto && a_tracked = chunk[static_cast<std::ptrdiff_t>(i)])
+            {
+                a_function(*a_tracked);
+            }
+        }
+    });
+}
+
+TRACKER_TEMPLATE
+template <typename Executor, typename Function>
+void
+TRACKER_TYPE::
+for_each_chunk(Executor & a_executor, Function && a_function)
+{
+    static_assert(has_data<Container_T const>::value, "Container must have contiguous data() to visit chunks in parallel");
+    tracked_span const objects{tracked_objects_.data(), tracked_objects_.size()};
+    a_executor.parallel_for((objects.size() + chunk_size - 1) / chunk_size, [&objects, &a_function](size_type a_chunk)
+    {
+        size_type const offset = a_chunk * chunk_size;
+        a_function(objects.subspan(offset, std::min(chunk_size, objects.size() - offset)));
+    });
+}
+
 TRACKER_TEMPLATE
 void
 TRACKER_TYPE::
 connect(trackable * a_trackable)
 {
     // Connect object and tracker together.
-    // Use insert() since it is used by all container types and will insert at the end for a vector.
-    assert(a_trackable and a_trackable->tracker_ != this);
-    a_trackable->tracker_ = this;
-    tracked_objects_.insert(std::end(tracked_objects_), std::move(a_trackable));
+    assert(a_trackable and not is_attached(a_trackable) and not wade::is_full(tracked_objects_));
+    auto && a_timer = start_timer(tracker_operation::connect);
+    (void)a_timer;
+    a_trackable->link_ = link();
+    wade::insert(tracked_objects_, a_trackable, hook_of{});
+    did_change();
+    this->stats_policy().record_size(tracked_objects_.size());
 }
 
 TRACKER_TEMPLATE
@@ -353,13 +1216,255 @@ TRACKER_TYPE::
 disconnect(trackable * a_trackable)
 {
     // Disconnect object and tracker from each other.
-    assert(a_trackable and a_trackable->tracker_ == this);
-    auto iter = wade::find(tracked_objects_, a_trackable);
-    assert(iter != std::cend(tracked_objects_));
-    tracked_objects_.erase(iter);
-    a_trackable->tracker_ = nullptr;
+    assert(is_attached(a_trackable));
+    auto && a_timer = start_timer(tracker_operation::disconnect);
+    (void)a_timer;
+    erase(a_trackable, is_deferrable{});
+    did_change();
+    clean(a_trackable);
+    a_trackable->link_ = Link_T{};
+}
+
+TRACKER_TEMPLATE
+Link_T const &
+TRACKER_TYPE::
+link()
+{
+    if (not link_)
+    {
+        link_ = Link_T::acquire(this);
+    }
+    return link_;
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+did_change()
+{
+    if (extension * an_extension = extension_.load(std::memory_order_relaxed))
+    {
+        an_extension->is_published_current = false;
+    }
+}
+
+TRACKER_TEMPLATE
+typename TRACKER_TYPE::extension &
+TRACKER_TYPE::
+extend()
+{
+    extension * an_extension = extension_.load(std::memory_order_relaxed);
+    if (not an_extension)
+    {
+        an_extension = new extension{};
+        extension_.store(an_extension, std::memory_order_release);
+    }
+    return *an_extension;
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+reserve(size_type a_capacity)
+{
+    wade::reserve(tracked_objects_, a_capacity);
+    this->tracker_dirty_objects().reserve(2 * a_capacity);
+    link();
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+publish()
+{
+    extension & an_extension = extend();
+    if (an_extension.is_published_current)
+    {
+        return;
+    }
+    std::vector<tracked_type *> objects{};
+    objects.reserve(tracked_objects_.size());
+    std::copy_if(std::begin(tracked_objects_), std::end(tracked_objects_), std::back_inserter(objects), [](tracked_type * a_tracked) { return a_tracked != nullptr; });
+    std::atomic_store(&an_extension.published, snapshot_ptr{std::make_shared<std::vector<tracked_type *> const>(std::move(objects))});
+    an_extension.is_published_current = true;
+}
+
+TRACKER_TEMPLATE
+typename TRACKER_TYPE::snapshot_ptr
+TRACKER_TYPE::
+snapshot() const
+{
+    extension const * an_extension = extension_.load(std::memory_order_acquire);
+    return an_extension ? std::atomic_load(&an_extension->published) : snapshot_ptr{};
+}
+
+TRACKER_TEMPLATE
+template <typename Function>
+typename TRACKER_TYPE::size_type
+TRACKER_TYPE::
+consume_dirty(Function && a_function)
+{
+    static_assert(Dirty_T::enabled, "Tracker must have a dirty policy that is enabled (i.e., wade::dirty_list) to consume dirty objects");
+    return this->tracker_dirty_objects().consume(std::forward<Function>(a_function), dirty_of{});
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+erase(trackable * a_trackable, std::true_type)
+{
+    if (is_deferring())
+    {
+        wade::erase_deferred(tracked_objects_, a_trackable, hook_of{});
+        ++deferred_count_;
+    }
+    else
+    {
+        wade::erase(tracked_objects_, a_trackable, hook_of{});
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+erase(trackable * a_trackable, std::false_type)
+{
+    wade::erase(tracked_objects_, a_trackable, hook_of{});
+}
+
+TRACKER_TEMPLATE
+typename TRACKER_TYPE::deferral
+TRACKER_TYPE::
+defer_detach()
+{
+    static_assert(is_deferrable::value, "Container must allow replacing objects in place or have a hook with erase_deferred() to defer detaching");
+    ++deferral_depth_;
+    return deferral{this};
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+end_deferral()
+{
+    // Erase all detached objects once the outermost deferral ends.
+    assert(is_deferring());
+    if (--deferral_depth_ == 0 and deferred_count_ != 0)
+    {
+        wade::compact(tracked_objects_, hook_of{});
+        deferred_count_ = 0;
+    }
+}
+
+TRACKER_TEMPLATE
+template <typename Iter>
+void
+TRACKER_TYPE::
+disconnect(Iter a_first, Iter a_last, std::vector<tracked_type *> & a_detached, std::true_type)
+{
+    // Mark objects as detached, then erase all marked objects together so the container is only traversed once.
+    for (; a_first != a_last; ++a_first)
+    {
+        trackable * a_trackable = get(*a_first);
+        if (is_attached(a_trackable))
+        {
+            clean(a_trackable);
+            a_trackable->link_ = Link_T{};
+            a_detached.push_back(a_trackable);
+        }
+    }
+    if (not a_detached.empty())
+    {
+        auto && is_marked = [this](tracked_type * a_tracked) { return not static_cast<trackable *>(a_tracked)->link_; };
+        tracked_objects_.erase(std::remove_if(std::begin(tracked_objects_), std::end(tracked_objects_), is_marked), std::end(tracked_objects_));
+        did_change();
+    }
+}
+
+TRACKER_TEMPLATE
+template <typename Iter>
+void
+TRACKER_TYPE::
+disconnect(Iter a_first, Iter a_last, std::vector<tracked_type *> & a_detached, std::false_type)
+{
+    for (; a_first != a_last; ++a_first)
+    {
+        trackable * a_trackable = get(*a_first);
+        if (is_attached(a_trackable))
+        {
+            disconnect(a_trackable);
+            a_detached.push_back(a_trackable);
+        }
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+did_make_all(tracked_span a_objects, std::true_type)
+{
+    if (not a_objects.empty())
+    {
+        TRACKER_NOTIFY(STATIC_DISPATCH, did_make_batch, a_objects);
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+did_make_all(tracked_span a_objects, std::false_type)
+{
+    for (auto && a_tracked : a_objects)
+    {
+        TRACKER_NOTIFY(OPTIONAL_STATIC_DISPATCH, did_make, *a_tracked);
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+did_attach_all(tracked_span a_objects, std::true_type)
+{
+    if (not a_objects.empty())
+    {
+        TRACKER_NOTIFY(STATIC_DISPATCH, did_attach_batch, a_objects);
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+did_attach_all(tracked_span a_objects, std::false_type)
+{
+    for (auto && a_tracked : a_objects)
+    {
+        TRACKER_NOTIFY(OPTIONAL_STATIC_DISPATCH, did_attach, *a_tracked);
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+did_detach_all(tracked_span a_objects, std::true_type)
+{
+    if (not a_objects.empty())
+    {
+        TRACKER_NOTIFY(STATIC_DISPATCH, did_detach_batch, a_objects);
+    }
+}
+
+TRACKER_TEMPLATE
+void
+TRACKER_TYPE::
+did_detach_all(tracked_span a_objects, std::false_type)
+{
+    for (auto && a_tracked : a_objects)
+    {
+        TRACKER_NOTIFY(OPTIONAL_STATIC_DISPATCH, did_detach, *a_tracked);
+    }
 }
 
+#undef TRACKER_NOTIFY
 #undef TRACKER_TYPE
 #undef TRACKER_TEMPLATE
 #undef TRACKER_TEMPLATE_DECL
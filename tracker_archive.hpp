@@ -0,0 +1,142 @@
+#pragma once
+
+#include "span.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+
+namespace wade {
+
+// Header at the start of an archive written by wade::save(), followed by the bytes of each object.
+// Archives are in the byte order and layout of the program that wrote them, so are only meant to be loaded by the same build (i.e., on a warm restart).
+struct archive_header
+{
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8] = {'w', 'a', 'd', 'e', 't', 'r', 'k', '\0'};
+    std::uint32_t version = current_version;
+    std::uint32_t object_size = 0;
+    std::uint64_t object_count = 0;
+    std::uint64_t reserved = 0;
+};
+
+}
+
+namespace {
+
+// Forward iterator that copies each object out of an archive's bytes, which need not be aligned for the object type.
+template <typename T>
+class archived_object_iterator
+{
+public:
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T const *;
+    using reference = T;
+
+    archived_object_iterator() = default;
+    explicit archived_object_iterator(char const * a_position) : position_{a_position} {}
+
+    T operator*() const { T an_object; std::memcpy(&an_object, position_, sizeof(T)); return an_object; }
+
+    archived_object_iterator & operator++() { position_ += sizeof(T); return *this; }
+    archived_object_iterator operator++(int) { archived_object_iterator result{*this}; ++*this; return result; }
+
+    bool operator==(archived_object_iterator const & rhs) const { return position_ == rhs.position_; }
+    bool operator!=(archived_object_iterator const & rhs) const { return position_ != rhs.position_; }
+
+private:
+
+    char const * position_ = nullptr;
+};
+
+}
+
+namespace wade {
+
+// Write the objects attached to a tracker to a binary stream, which must be opened in binary mode. For example:
+//   std::ofstream file{"objects.bin", std::ios::binary};
+//   wade::save(tracker, file);
+// Tracked_T must be trivially copyable, since objects are written as bytes (so pointers in objects are not meaningful once loaded by another process).
+// Throws std::runtime_error if writing fails.
+template <typename Tracker_T>
+void save(Tracker_T const & a_tracker, std::ostream & a_stream)
+{
+    using tracked_type = typename Tracker_T::tracked_type;
+    static_assert(std::is_trivially_copyable<tracked_type>::value, "Tracked type must be trivially copyable to save");
+
+    // Note: skip objects detached while deferring.
+    archive_header a_header{};
+    a_header.object_size = sizeof(tracked_type);
+    for (auto && a_tracked : a_tracker.tracked_objects())
+    {
+        a_header.object_count += a_tracked ? 1 : 0;
+    }
+    a_stream.write(reinterpret_cast<char const *>(&a_header), sizeof(a_header));
+    for (auto && a_tracked : a_tracker.tracked_objects())
+    {
+        if (a_tracked)
+        {
+            a_stream.write(reinterpret_cast<char const *>(static_cast<tracked_type const *>(a_tracked)), sizeof(tracked_type));
+        }
+    }
+    if (not a_stream)
+    {
+        throw std::runtime_error{"Failed to write archive"};
+    }
+}
+
+// Make an attached object from each object in an archive in memory, such as a memory-mapped file, with a single call to did_make_batch()
+// (see tracker::make_each()), instead of making each object and calling did_make(). Returns the made objects.
+// The archive is only read, and may be unmapped once loaded. Throws std::runtime_error if it was not saved with the same object type.
+template <typename Tracker_T>
+std::vector<typename Tracker_T::trackable_ptr> load(Tracker_T & a_tracker, span<char const> an_archive)
+{
+    using tracked_type = typename Tracker_T::tracked_type;
+    static_assert(std::is_trivially_copyable<tracked_type>::value, "Tracked type must be trivially copyable to load");
+
+    archive_header a_header{};
+    if (an_archive.size() < sizeof(a_header))
+    {
+        throw std::runtime_error{"Archive is too short"};
+    }
+    std::memcpy(&a_header, an_archive.data(), sizeof(a_header));
+    if (std::memcmp(a_header.magic, archive_header{}.magic, sizeof(a_header.magic)) != 0 or a_header.version != archive_header::current_version)
+    {
+        throw std::runtime_error{"Archive has an unknown format"};
+    }
+    if (a_header.object_size != sizeof(tracked_type))
+    {
+        throw std::runtime_error{"Archive has objects of a different type"};
+    }
+    if (a_header.object_count > (an_archive.size() - sizeof(a_header)) / sizeof(tracked_type))
+    {
+        throw std::runtime_error{"Archive is too short"};
+    }
+
+    auto && first = an_archive.data() + sizeof(a_header);
+    auto && last = first + static_cast<std::size_t>(a_header.object_count) * sizeof(tracked_type);
+    return a_tracker.make_each(archived_object_iterator<tracked_type>{first}, archived_object_iterator<tracked_type>{last});
+}
+
+// Make an attached object from each object in an archive read from a binary stream, which is read into memory first.
+// Prefer loading from a memory-mapped file to avoid copying the archive.
+template <typename Tracker_T>
+std::vector<typename Tracker_T::trackable_ptr> load(Tracker_T & a_tracker, std::istream & a_stream)
+{
+    std::vector<char> an_archive{std::istreambuf_iterator<char>{a_stream}, std::istreambuf_iterator<char>{}};
+    return load(a_tracker, span<char const>{an_archive.data(), an_archive.size()});
+}
+
+}
+
@@ -0,0 +1,414 @@
+// Benchmarks for tracker.
+// Build and run, writing results as JSON to tracker_bench.json:
+//   $ make bench
+// Or run a subset, such as only operations on vectors:
+//   $ make tracker_bench && ./tracker_bench --benchmark_filter='<bench_vector>' --benchmark_format=json
+
+#include "flat_hash_set.hpp"
+#include "flat_set.hpp"
+#include "intrusive_list.hpp"
+#include "slot_map.hpp"
+#include "small_vector.hpp"
+#include "soa_tracker.hpp"
+#include "thread_pool.hpp"
+#include "tracker.hpp"
+#include "unordered_vector.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+namespace {
+
+struct bench_type
+{
+    std::int64_t value = 0;
+};
+
+// Define trackers that do nothing when notified, so only the tracker itself is measured.
+struct bench_tracker
+    : public wade::tracker<bench_tracker, bench_type>
+{
+    void did_make(bench_type &) {}
+    void did_attach(bench_type &) {}
+    void did_detach(bench_type &) {}
+};
+
+// Define the same tracker for each container.
+#define DEFINE_BENCH_TRACKER(TRACKER_TYPE, CONTAINER_TYPE) \
+    struct TRACKER_TYPE \
+        : public TRACKER_WITH_CONTAINER(TRACKER_TYPE, bench_type, CONTAINER_TYPE) \
+    { \
+        void did_make(bench_type &) {} \
+        void did_attach(bench_type &) {} \
+        void did_detach(bench_type &) {} \
+    };
+
+DEFINE_BENCH_TRACKER(bench_vector, std::vector)
+DEFINE_BENCH_TRACKER(bench_set, std::set)
+DEFINE_BENCH_TRACKER(bench_unordered_vector, wade::unordered_vector)
+DEFINE_BENCH_TRACKER(bench_slot_map, wade::slot_map)
+DEFINE_BENCH_TRACKER(bench_flat_hash_set, wade::flat_hash_set)
+DEFINE_BENCH_TRACKER(bench_flat_set, wade::flat_set)
+DEFINE_BENCH_TRACKER(bench_intrusive_list, wade::intrusive_list)
+DEFINE_BENCH_TRACKER(bench_small_vector, wade::small_vector)
+
+// Define a vector tracker with stable links, which moves in constant time.
+struct bench_stable_vector
+    : public wade::tracker<bench_stable_vector, bench_type, std::vector<bench_type *>, std::allocator<bench_type>, wade::no_stats, wade::stable_link>
+{
+    void did_make(bench_type &) {}
+    void did_attach(bench_type &) {}
+    void did_detach(bench_type &) {}
+};
+
+struct bench_soa_tracker
+    : public wade::soa_tracker<bench_soa_tracker, std::int64_t>
+{
+    void did_make(handle &) {}
+    void did_detach(handle &) {}
+};
+
+// Sizes of trackers to benchmark.
+void sizes(benchmark::internal::Benchmark * a_benchmark)
+{
+    a_benchmark->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+}
+
+// Sizes of trackers to benchmark operations with, from 10 to 10 million objects.
+void operation_sizes(benchmark::internal::Benchmark * a_benchmark)
+{
+    a_benchmark->RangeMultiplier(10)->Range(10, 10000000);
+}
+
+// Number of objects of a benchmark as a size.
+std::size_t size_of(benchmark::State const & a_state)
+{
+    return static_cast<std::size_t>(a_state.range(0));
+}
+
+// Make a number of objects, then detach all without timing.
+// Note: timing is paused for each tracker's teardown, which adds a fixed overhead per iteration.
+template <typename Tracker_T>
+void bench_make(benchmark::State & a_state)
+{
+    std::size_t const size = size_of(a_state);
+    for (auto _ : a_state)
+    {
+        Tracker_T tracker{};
+        std::vector<typename Tracker_T::trackable_ptr> owner{};
+        owner.reserve(size);
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            owner.push_back(tracker.make());
+        }
+        benchmark::DoNotOptimize(owner.data());
+
+        a_state.PauseTiming();
+        tracker.detach_all();
+        owner.clear();
+        a_state.ResumeTiming();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+}
+
+// Attach a number of detached objects, then detach all without timing.
+template <typename Tracker_T>
+void bench_attach(benchmark::State & a_state)
+{
+    std::vector<typename Tracker_T::trackable> objects(size_of(a_state));
+    Tracker_T tracker{};
+    for (auto _ : a_state)
+    {
+        for (auto && an_object : objects)
+        {
+            tracker.attach(&an_object);
+        }
+        benchmark::ClobberMemory();
+
+        a_state.PauseTiming();
+        tracker.detach_all();
+        a_state.ResumeTiming();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+}
+
+// Detach and reattach an object in the middle of a tracker, which searches and shifts a vector but not other containers.
+template <typename Tracker_T>
+void bench_detach(benchmark::State & a_state)
+{
+    Tracker_T tracker{};
+    auto && owner = tracker.make_n(size_of(a_state));
+    auto && an_object = owner[owner.size() / 2];
+    for (auto _ : a_state)
+    {
+        tracker.detach(an_object);
+        tracker.attach(an_object);
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations());
+    tracker.detach_all();
+}
+
+// Detach all objects at once, reattaching them without timing.
+template <typename Tracker_T>
+void bench_detach_all(benchmark::State & a_state)
+{
+    Tracker_T tracker{};
+    auto && owner = tracker.make_n(size_of(a_state));
+    for (auto _ : a_state)
+    {
+        tracker.detach_all();
+        benchmark::ClobberMemory();
+
+        a_state.PauseTiming();
+        tracker.attach(std::begin(owner), std::end(owner));
+        a_state.ResumeTiming();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+    tracker.detach_all();
+}
+
+// Migrate half of the objects to another tracker and back.
+template <typename Tracker_T>
+void bench_migrate(benchmark::State & a_state)
+{
+    Tracker_T tracker{};
+    auto && owner = tracker.make_n(size_of(a_state));
+    for (std::size_t i = 0; i != owner.size(); ++i)
+    {
+        owner[i]->value = static_cast<std::int64_t>(i % 2);
+    }
+    Tracker_T tracker_2{};
+    for (auto _ : a_state)
+    {
+        tracker_2.migrate_from(tracker, [](bench_type const & a_tracked) { return a_tracked.value != 0; });
+        tracker.migrate_from(tracker_2, [](bench_type const &) { return true; });
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * (a_state.range(0) / 2) * 2);
+}
+
+// Move all objects between two trackers, which takes constant time with a link policy that can retarget (i.e., bench_stable_vector),
+// or linear time otherwise.
+template <typename Tracker_T>
+void bench_move_tracker(benchmark::State & a_state)
+{
+    Tracker_T tracker{};
+    auto && owner = tracker.make_n(size_of(a_state));
+    Tracker_T tracker_2{};
+    for (auto _ : a_state)
+    {
+        tracker_2 = std::move(tracker);
+        tracker = std::move(tracker_2);
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * 2);
+    tracker.detach_all();
+}
+
+// Copy an attached object, which attaches the copy, and then delete the copy, which detaches it.
+template <typename Tracker_T>
+void bench_copy_trackable(benchmark::State & a_state)
+{
+    Tracker_T tracker{};
+    auto && owner = tracker.make_n(size_of(a_state));
+    for (auto _ : a_state)
+    {
+        typename Tracker_T::trackable copy{*owner.front()};
+        benchmark::DoNotOptimize(&copy);
+    }
+    a_state.SetItemsProcessed(a_state.iterations());
+    tracker.detach_all();
+}
+
+// Move an attached object back and forth, which detaches one object and attaches the other each time.
+template <typename Tracker_T>
+void bench_move_trackable(benchmark::State & a_state)
+{
+    Tracker_T tracker{};
+    auto && owner = tracker.make_n(size_of(a_state));
+    typename Tracker_T::trackable other{};
+    for (auto _ : a_state)
+    {
+        other = std::move(*owner.back());
+        *owner.back() = std::move(other);
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * 2);
+    tracker.detach_all();
+}
+
+// Visit all objects with a range-for over tracked_objects().
+template <typename Tracker_T>
+void bench_iterate(benchmark::State & a_state)
+{
+    Tracker_T tracker{};
+    auto && owner = tracker.make_n(size_of(a_state));
+    for (auto _ : a_state)
+    {
+        for (auto && a_tracked : tracker.tracked_objects())
+        {
+            a_tracked->value += 1;
+        }
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+    tracker.detach_all();
+}
+
+// Register each operation for each container.
+#define BENCHMARK_OPERATIONS(TRACKER_TYPE) \
+    BENCHMARK_TEMPLATE(bench_make, TRACKER_TYPE)->Apply(operation_sizes); \
+    BENCHMARK_TEMPLATE(bench_attach, TRACKER_TYPE)->Apply(operation_sizes); \
+    BENCHMARK_TEMPLATE(bench_detach, TRACKER_TYPE)->Apply(operation_sizes); \
+    BENCHMARK_TEMPLATE(bench_detach_all, TRACKER_TYPE)->Apply(operation_sizes); \
+    BENCHMARK_TEMPLATE(bench_migrate, TRACKER_TYPE)->Apply(operation_sizes); \
+    BENCHMARK_TEMPLATE(bench_move_tracker, TRACKER_TYPE)->Apply(operation_sizes); \
+    BENCHMARK_TEMPLATE(bench_copy_trackable, TRACKER_TYPE)->Apply(operation_sizes); \
+    BENCHMARK_TEMPLATE(bench_move_trackable, TRACKER_TYPE)->Apply(operation_sizes); \
+    BENCHMARK_TEMPLATE(bench_iterate, TRACKER_TYPE)->Apply(operation_sizes);
+
+BENCHMARK_OPERATIONS(bench_vector)
+BENCHMARK_OPERATIONS(bench_set)
+BENCHMARK_OPERATIONS(bench_unordered_vector)
+BENCHMARK_OPERATIONS(bench_slot_map)
+BENCHMARK_OPERATIONS(bench_flat_hash_set)
+BENCHMARK_OPERATIONS(bench_flat_set)
+BENCHMARK_OPERATIONS(bench_intrusive_list)
+BENCHMARK_OPERATIONS(bench_small_vector)
+BENCHMARK_OPERATIONS(bench_stable_vector)
+
+// Update the value of all objects with a range-for over tracked_objects().
+void update_scalar(benchmark::State & a_state)
+{
+    bench_tracker tracker{};
+    auto && owner = tracker.make_n(static_cast<std::size_t>(a_state.range(0)));
+    for (auto _ : a_state)
+    {
+        for (auto && a_tracked : tracker.tracked_objects())
+        {
+            a_tracked->value += 1;
+        }
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * static_cast<std::int64_t>(owner.size()));
+
+    // Detach all at once, since deleting each object from a vector would detach it in linear time.
+    tracker.detach_all();
+}
+BENCHMARK(update_scalar)->Apply(sizes);
+
+// Update all objects with for_each().
+void update_for_each(benchmark::State & a_state)
+{
+    bench_tracker tracker{};
+    auto && owner = tracker.make_n(static_cast<std::size_t>(a_state.range(0)));
+    for (auto _ : a_state)
+    {
+        tracker.for_each([](bench_type & a_tracked) { a_tracked.value += 1; });
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * static_cast<std::int64_t>(owner.size()));
+
+    // Detach all at once, since deleting each object from a vector would detach it in linear time.
+    tracker.detach_all();
+}
+BENCHMARK(update_for_each)->Apply(sizes);
+
+// Update all objects with for_each_chunk(), which still dereferences each object.
+void update_chunked(benchmark::State & a_state)
+{
+    bench_tracker tracker{};
+    auto && owner = tracker.make_n(static_cast<std::size_t>(a_state.range(0)));
+    for (auto _ : a_state)
+    {
+        tracker.for_each_chunk([](bench_tracker::tracked_span a_chunk)
+        {
+            for (std::size_t i = 0; i != a_chunk.size(); ++i)
+            {
+                a_chunk[i]->value += 1;
+            }
+        });
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * static_cast<std::int64_t>(owner.size()));
+
+    // Detach all at once, since deleting each object from a vector would detach it in linear time.
+    tracker.detach_all();
+}
+BENCHMARK(update_chunked)->Apply(sizes);
+
+// Update all objects in parallel with for_each() and a thread pool.
+void update_parallel(benchmark::State & a_state)
+{
+    wade::thread_pool pool{};
+    bench_tracker tracker{};
+    auto && owner = tracker.make_n(static_cast<std::size_t>(a_state.range(0)));
+    for (auto _ : a_state)
+    {
+        tracker.for_each(pool, [](bench_type & a_tracked) { a_tracked.value += 1; });
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * static_cast<std::int64_t>(owner.size()));
+
+    // Detach all at once, since deleting each object from a vector would detach it in linear time.
+    tracker.detach_all();
+}
+BENCHMARK(update_parallel)->Apply(sizes)->UseRealTime();
+
+// Update the same field stored in a column of a soa_tracker, one object at a time.
+void update_soa_for_each(benchmark::State & a_state)
+{
+    bench_soa_tracker tracker{};
+    std::vector<bench_soa_tracker::handle> owner{};
+    for (std::int64_t i = 0; i != a_state.range(0); ++i)
+    {
+        owner.push_back(tracker.make());
+    }
+    for (auto _ : a_state)
+    {
+        tracker.for_each<0>([](std::int64_t & a_value) { a_value += 1; });
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * static_cast<std::int64_t>(owner.size()));
+}
+BENCHMARK(update_soa_for_each)->Apply(sizes);
+
+// Update the same field in aligned chunks, which the compiler can vectorize.
+void update_soa_chunked(benchmark::State & a_state)
+{
+    bench_soa_tracker tracker{};
+    std::vector<bench_soa_tracker::handle> owner{};
+    for (std::int64_t i = 0; i != a_state.range(0); ++i)
+    {
+        owner.push_back(tracker.make());
+    }
+    for (auto _ : a_state)
+    {
+        tracker.for_each_chunk<0>([](wade::span<std::int64_t> a_values)
+        {
+            std::int64_t * values = a_values.data();
+            for (std::size_t i = 0; i != a_values.size(); ++i)
+            {
+                values[i] += 1;
+            }
+        });
+        benchmark::ClobberMemory();
+    }
+    a_state.SetItemsProcessed(a_state.iterations() * static_cast<std::int64_t>(owner.size()));
+}
+BENCHMARK(update_soa_chunked)->Apply(sizes);
+
+}
+
+}
+
+BENCHMARK_MAIN();
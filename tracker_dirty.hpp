@@ -0,0 +1,334 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace wade {
+
+// Dirty policy that lets no objects be marked dirty, which trackers use by default, so objects store nothing for it.
+// A dirty policy is given as the last template parameter of a tracker, and is stored in each object to find its place in the tracker's dirty list.
+// It must be default-constructible as not dirty, and define:
+//   static constexpr bool enabled; // Whether objects may be marked dirty.
+//   std::uint32_t get() const; // Position in the dirty list plus one, or 0 if not dirty.
+//   void set(std::uint32_t);
+struct no_dirty_list
+{
+    static constexpr bool enabled = false;
+
+    std::uint32_t get() const { return 0; }
+    void set(std::uint32_t) {}
+};
+
+// Dirty policy that stores the position of each object in its tracker's dirty list, so objects may be marked with trackable::mark_dirty()
+// and consumed with tracker::consume_dirty(). For example:
+//   struct Mytracker : wade::tracker<Mytracker, MyClass, std::vector<MyClass *>, std::allocator<MyClass>, wade::no_stats, wade::pointer_link, wade::dirty_list> {};
+// Note: 32 bits so that it packs with a compact link (see wade::compact_link), which limits a dirty list to UINT32_MAX - 1 entries.
+class dirty_list
+{
+public:
+
+    static constexpr bool enabled = true;
+
+    std::uint32_t get() const { return index_; }
+    void set(std::uint32_t an_index) { index_ = an_index; }
+
+private:
+
+    std::uint32_t index_ = 0;
+};
+
+// Storage for the dirty policy of a tracked object (like hook_holder for hooks).
+// An empty policy takes no space when used as a base class (empty base optimization).
+// Member names are prefixed to avoid colliding with the names of the tracked type.
+template <typename Dirty_T, bool = std::is_empty<Dirty_T>::value>
+class dirty_holder
+{
+public:
+
+    Dirty_T & tracker_dirty() { return tracker_dirty_; }
+    Dirty_T const & tracker_dirty() const { return tracker_dirty_; }
+
+protected:
+
+    // Never copied or moved with their objects since they describe a position in a specific tracker's list.
+    dirty_holder() = default;
+    dirty_holder(dirty_holder const &) : tracker_dirty_{} {}
+    dirty_holder & operator=(dirty_holder const &) { return *this; }
+    ~dirty_holder() = default;
+
+private:
+
+    Dirty_T tracker_dirty_{};
+};
+
+template <typename Dirty_T>
+class dirty_holder<Dirty_T, true>
+    : private Dirty_T
+{
+public:
+
+    Dirty_T & tracker_dirty() { return *this; }
+    Dirty_T const & tracker_dirty() const { return *this; }
+
+protected:
+
+    dirty_holder() = default;
+    dirty_holder(dirty_holder const &) {}
+    dirty_holder & operator=(dirty_holder const &) { return *this; }
+    ~dirty_holder() = default;
+};
+
+
+// Objects marked dirty in a tracker, in the order marked, which trackers store only for a dirty policy that is enabled (see dirty_objects_holder).
+// Objects are given as pointers to T, and Dirty_Of is a function object that gets the dirty policy stored in an object (like Hook_Of for containers).
+// Cleaning an object leaves nullptr in its place so no others move, and adding to a full list erases the nullptr first if at least half the list is nullptr,
+// so the list does not grow past twice the number of dirty objects.
+template <typename T>
+class dirty_objects
+{
+public:
+
+    using size_type = std::size_t;
+
+    // Moving leaves rhs empty.
+    dirty_objects() = default;
+    dirty_objects(dirty_objects const &) = delete;
+    dirty_objects & operator=(dirty_objects const &) = delete;
+    dirty_objects(dirty_objects && rhs)
+        : objects_(std::move(rhs.objects_))
+        , holes_{rhs.holes_}
+    {
+        rhs.objects_.clear();
+        rhs.holes_ = 0;
+    }
+    dirty_objects & operator=(dirty_objects && rhs)
+    {
+        if (this != &rhs)
+        {
+            objects_ = std::move(rhs.objects_);
+            holes_ = rhs.holes_;
+            rhs.objects_.clear();
+            rhs.holes_ = 0;
+        }
+        return *this;
+    }
+
+    // Add an object that is not dirty. Returns true if added, and false if already dirty.
+    template <typename Dirty_Of>
+    bool mark(T *, Dirty_Of const &);
+
+    // Remove an object if it is dirty.
+    template <typename Dirty_Of>
+    void clean(T *, Dirty_Of const &);
+
+    // Remove all objects.
+    template <typename Dirty_Of>
+    void clean_all(Dirty_Of const &);
+
+    // Call a function with a reference to each object in the order marked, after marking it clean (see tracker::consume_dirty()).
+    // Returns the number of objects consumed.
+    template <typename Function, typename Dirty_Of>
+    size_type consume(Function &&, Dirty_Of const &);
+
+    // Reserve room for objects and the nullptr left by cleaning them.
+    void reserve(size_type a_capacity) { objects_.reserve(a_capacity); }
+
+    // Number of dirty objects, plus any nullptr left by cleaning them until the list is compacted.
+    size_type size() const { return objects_.size(); }
+
+private:
+
+    // Erase nullptr in one pass, keeping objects in the order marked.
+    template <typename Dirty_Of>
+    void compact(Dirty_Of const &);
+
+    std::vector<T *> objects_{};
+
+    // Number of nullptr in the list, and whether it is being consumed (so it must not be compacted).
+    size_type holes_ = 0;
+    bool is_consuming_ = false;
+};
+
+template <typename T>
+template <typename Dirty_Of>
+bool
+dirty_objects<T>::
+mark(T * an_object, Dirty_Of const & a_dirty_of)
+{
+    if (a_dirty_of(an_object).get() != 0)
+    {
+        return false;
+    }
+    if (objects_.size() == objects_.capacity() and holes_ != 0 and holes_ * 2 >= objects_.size() and not is_consuming_)
+    {
+        compact(a_dirty_of);
+    }
+    assert(objects_.size() < UINT32_MAX);
+    objects_.push_back(an_object);
+    a_dirty_of(an_object).set(static_cast<std::uint32_t>(objects_.size()));
+    return true;
+}
+
+template <typename T>
+template <typename Dirty_Of>
+void
+dirty_objects<T>::
+clean(T * an_object, Dirty_Of const & a_dirty_of)
+{
+    auto && a_dirty = a_dirty_of(an_object);
+    if (a_dirty.get() != 0)
+    {
+        // Note: the last object can be removed without moving any others.
+        if (a_dirty.get() == objects_.size() and not is_consuming_)
+        {
+            objects_.pop_back();
+        }
+        else
+        {
+            objects_[a_dirty.get() - 1] = nullptr;
+            ++holes_;
+        }
+        a_dirty.set(0);
+    }
+}
+
+template <typename T>
+template <typename Dirty_Of>
+void
+dirty_objects<T>::
+clean_all(Dirty_Of const & a_dirty_of)
+{
+    for (auto && an_object : objects_)
+    {
+        if (an_object)
+        {
+            a_dirty_of(an_object).set(0);
+        }
+    }
+    objects_.clear();
+    holes_ = 0;
+}
+
+template <typename T>
+template <typename Function, typename Dirty_Of>
+typename dirty_objects<T>::size_type
+dirty_objects<T>::
+consume(Function && a_function, Dirty_Of const & a_dirty_of)
+{
+    // Only consume objects marked before this call, leaving objects marked by the function for the next call.
+    // Note: the list is not compacted (and its last object not removed) while consuming it, since that would move objects not yet consumed.
+    size_type const count = objects_.size();
+    size_type consumed = 0;
+    is_consuming_ = true;
+    try
+    {
+        for (size_type i = 0; i != count; ++i)
+        {
+            T * an_object = objects_[i];
+            if (an_object)
+            {
+                objects_[i] = nullptr;
+                a_dirty_of(an_object).set(0);
+                ++consumed;
+                a_function(*an_object);
+            }
+        }
+    }
+    catch (...)
+    {
+        is_consuming_ = false;
+        throw;
+    }
+    is_consuming_ = false;
+
+    // Move objects marked by the function to the front of the list, and count the nullptr left among them.
+    objects_.erase(std::begin(objects_), std::begin(objects_) + static_cast<std::ptrdiff_t>(count));
+    holes_ = 0;
+    for (size_type i = 0; i != objects_.size(); ++i)
+    {
+        if (objects_[i])
+        {
+            a_dirty_of(objects_[i]).set(static_cast<std::uint32_t>(i + 1));
+        }
+        else
+        {
+            ++holes_;
+        }
+    }
+    return consumed;
+}
+
+template <typename T>
+template <typename Dirty_Of>
+void
+dirty_objects<T>::
+compact(Dirty_Of const & a_dirty_of)
+{
+    objects_.erase(std::remove(std::begin(objects_), std::end(objects_), nullptr), std::end(objects_));
+    for (size_type i = 0; i != objects_.size(); ++i)
+    {
+        a_dirty_of(objects_[i]).set(static_cast<std::uint32_t>(i + 1));
+    }
+    holes_ = 0;
+}
+
+// No dirty objects, for a dirty policy that is not enabled, whose objects are never dirty.
+template <typename T>
+struct no_dirty_objects
+{
+    using size_type = std::size_t;
+
+    template <typename Dirty_Of>
+    bool mark(T *, Dirty_Of const &) { return false; }
+    template <typename Dirty_Of>
+    void clean(T *, Dirty_Of const &) {}
+    template <typename Dirty_Of>
+    void clean_all(Dirty_Of const &) {}
+    void reserve(size_type) {}
+    size_type size() const { return 0; }
+};
+
+// Storage for a tracker's dirty objects (like stats_holder for stats), which stores nothing for a dirty policy that is not enabled.
+// Member names are prefixed to avoid colliding with the names of the derived class.
+template <typename T, typename Dirty_T, bool = Dirty_T::enabled>
+class dirty_objects_holder
+{
+public:
+
+    dirty_objects<T> & tracker_dirty_objects() { return tracker_dirty_objects_; }
+    dirty_objects<T> const & tracker_dirty_objects() const { return tracker_dirty_objects_; }
+
+protected:
+
+    dirty_objects_holder() = default;
+    dirty_objects_holder(dirty_objects_holder &&) = default;
+    dirty_objects_holder & operator=(dirty_objects_holder &&) = default;
+    ~dirty_objects_holder() = default;
+
+private:
+
+    dirty_objects<T> tracker_dirty_objects_{};
+};
+
+template <typename T, typename Dirty_T>
+class dirty_objects_holder<T, Dirty_T, false>
+{
+public:
+
+    no_dirty_objects<T> tracker_dirty_objects() const { return no_dirty_objects<T>{}; }
+
+protected:
+
+    dirty_objects_holder() = default;
+    ~dirty_objects_holder() = default;
+};
+
+}
+
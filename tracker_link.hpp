@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+
+namespace wade {
+
+// Link policy that stores a pointer to the tracker in each object, which trackers use by default.
+// A link policy is given as a template parameter of a tracker, and is the type stored in each object (and in the tracker) to find its tracker.
+// It must be default-constructible as a null link, comparable with == and !=, and define:
+//   static Link acquire(void *); // Make a link to a tracker, once it first attaches an object.
+//   static void release(Link); // Release a link (which may be null) when its tracker is destroyed.
+//   void * get() const; // Get the linked tracker.
+//   explicit operator bool() const; // Whether the link is not null.
+// It may also define this to move a tracker in constant time, since its objects keep their links:
+//   static void retarget(Link, void *); // Make a link refer to a tracker that was moved to another address.
+// Otherwise, moving a tracker links each of its objects to the moved tracker, which takes linear time.
+// A pointer link costs no allocation, but moving its tracker takes linear time (see wade::stable_link).
+class pointer_link
+{
+public:
+
+    pointer_link() = default;
+
+    static pointer_link acquire(void * a_tracker) { return pointer_link{a_tracker}; }
+    static void release(pointer_link) {}
+
+    void * get() const { return tracker_; }
+    explicit operator bool() const { return tracker_ != nullptr; }
+
+    bool operator==(pointer_link const & rhs) const { return tracker_ == rhs.tracker_; }
+    bool operator!=(pointer_link const & rhs) const { return tracker_ != rhs.tracker_; }
+
+private:
+
+    explicit pointer_link(void * a_tracker) : tracker_{a_tracker} {}
+
+    void * tracker_ = nullptr;
+};
+
+// Link policy that stores a pointer to a small control block in each object, which points to the tracker and stays in place when the tracker moves,
+// so moving a tracker only updates the block instead of every object. For example:
+//   struct Mytracker : wade::tracker<Mytracker, MyClass, std::vector<MyClass *>, std::allocator<MyClass>, wade::no_stats, wade::stable_link> {};
+// The block is allocated once the tracker first attaches an object (or reserves), and finding an object's tracker costs an extra load from it.
+class stable_link
+{
+public:
+
+    stable_link() = default;
+
+    static stable_link acquire(void * a_tracker) { return stable_link{new control_block{a_tracker}}; }
+    static void release(stable_link a_link) { delete a_link.control_; }
+    static void retarget(stable_link a_link, void * a_tracker) { a_link.control_->tracker = a_tracker; }
+
+    void * get() const { return control_ ? control_->tracker : nullptr; }
+    explicit operator bool() const { return control_ != nullptr; }
+
+    bool operator==(stable_link const & rhs) const { return control_ == rhs.control_; }
+    bool operator!=(stable_link const & rhs) const { return control_ != rhs.control_; }
+
+private:
+
+    // Block owned by the tracker, which all of its objects link to.
+    struct control_block
+    {
+        void * tracker = nullptr;
+    };
+
+    explicit stable_link(control_block * a_control) : control_{a_control} {}
+
+    control_block * control_ = nullptr;
+};
+
+// Link policy that stores a 32-bit id of the tracker in each object, which is looked up in a global table,
+// so each object stores 8 bytes (with its place in a dirty list, see wade::dirty_list) rather than 16 to refer to its tracker,
+// or 4 bytes rather than 8 for tracked types aligned to 4 bytes or less. For example:
+//   struct Mytracker : wade::tracker<Mytracker, MyClass, std::vector<MyClass *>, std::allocator<MyClass>, wade::no_stats, wade::compact_link> {};
+// Finding an object's tracker (i.e., to detach it) costs an extra load from the table, but checking whether an object is attached does not.
+// Ids are acquired once a tracker first attaches an object, and are reused once the tracker is destroyed.
+// Moving a tracker takes constant time, since only its entry in the table is updated.
+// Up to max_count trackers may hold ids at once, and acquiring more throws std::length_error.
+class compact_link
+{
+public:
+
+    using id_type = std::uint32_t;
+
+    // Ids are grouped into chunks of the table, which are allocated as needed and never move, so looking up an id needs no lock.
+    static constexpr std::size_t chunk_size = 4096;
+    static constexpr std::size_t chunk_count = 4096;
+    static constexpr std::size_t max_count = chunk_size * chunk_count - 1;
+
+    compact_link() = default;
+
+    static compact_link acquire(void *);
+    static void release(compact_link);
+    static void retarget(compact_link, void *);
+
+    void * get() const { return id_ ? table().chunks[id_ / chunk_size][id_ % chunk_size] : nullptr; }
+    explicit operator bool() const { return id_ != 0; }
+
+    bool operator==(compact_link const & rhs) const { return id_ == rhs.id_; }
+    bool operator!=(compact_link const & rhs) const { return id_ != rhs.id_; }
+
+    // Id stored in objects, where 0 is a null link.
+    id_type id() const { return id_; }
+
+private:
+
+    // Trackers by id, where id 0 is never used.
+    // Note: acquiring, retargeting, or releasing an id writes only its own entry under the lock, and an id is only looked up by objects attached after it was acquired.
+    struct id_table
+    {
+        std::mutex mutex{};
+        std::unique_ptr<void *[]> chunks[chunk_count]{};
+        std::vector<id_type> free_ids{};
+        id_type next_id = 1;
+    };
+
+    // Note: never deleted, so trackers destroyed after static destruction starts can still release their ids.
+    static id_table & table()
+    {
+        static id_table * const a_table = new id_table{};
+        return *a_table;
+    }
+
+    explicit compact_link(id_type an_id) : id_{an_id} {}
+
+    id_type id_ = 0;
+};
+
+inline
+compact_link
+compact_link::
+acquire(void * a_tracker)
+{
+    id_table & a_table = table();
+    std::lock_guard<std::mutex> lock{a_table.mutex};
+    id_type an_id = 0;
+    if (not a_table.free_ids.empty())
+    {
+        an_id = a_table.free_ids.back();
+        a_table.free_ids.pop_back();
+    }
+    else
+    {
+        if (a_table.next_id > max_count)
+        {
+            throw std::length_error{"Too many trackers with compact links"};
+        }
+        an_id = a_table.next_id++;
+        auto && chunk = a_table.chunks[an_id / chunk_size];
+        if (not chunk)
+        {
+            chunk.reset(new void *[chunk_size]{});
+        }
+    }
+    a_table.chunks[an_id / chunk_size][an_id % chunk_size] = a_tracker;
+    return compact_link{an_id};
+}
+
+inline
+void
+compact_link::
+retarget(compact_link a_link, void * a_tracker)
+{
+    id_table & a_table = table();
+    std::lock_guard<std::mutex> lock{a_table.mutex};
+    a_table.chunks[a_link.id_ / chunk_size][a_link.id_ % chunk_size] = a_tracker;
+}
+
+inline
+void
+compact_link::
+release(compact_link a_link)
+{
+    if (a_link)
+    {
+        id_table & a_table = table();
+        std::lock_guard<std::mutex> lock{a_table.mutex};
+        a_table.chunks[a_link.id_ / chunk_size][a_link.id_ % chunk_size] = nullptr;
+        a_table.free_ids.push_back(a_link.id_);
+    }
+}
+
+}
+
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+
+namespace wade {
+
+// Operations of a tracker that a stats policy measures.
+enum class tracker_operation
+{
+    make, // Whole make(), including connecting and calling did_make().
+    connect, // Inserting an object into the container.
+    disconnect, // Erasing an object from the container.
+    dispatch, // Calling a method of the derived class.
+};
+
+constexpr std::size_t tracker_operation_count = 4;
+
+// Stats policy that measures nothing and compiles away completely, which trackers use by default.
+// A stats policy is given as the last template parameter of a tracker, and must define:
+//   using snapshot_type = ...; // Returned by tracker::stats().
+//   timer_type start(tracker_operation); // Start timing an operation, which ends when the returned object is destroyed.
+//   void record_size(std::size_t); // Record the number of tracked objects after connecting one.
+//   snapshot_type snapshot() const; // Get the stats so far.
+struct no_stats
+{
+    struct snapshot_type
+    {
+    };
+    struct timer
+    {
+    };
+
+    timer start(tracker_operation) { return timer{}; }
+    void record_size(std::size_t) {}
+    snapshot_type snapshot() const { return snapshot_type{}; }
+};
+
+// Stats policy that counts and times each operation, and records the largest number of tracked objects. For example:
+//   struct Mytracker : wade::tracker<Mytracker, MyClass, std::vector<MyClass *>, std::allocator<MyClass>, wade::tracker_stats> {};
+//   auto && erase_time = tracker.stats()[wade::tracker_operation::disconnect].total_nanoseconds;
+// Latencies are counted in a histogram with a bucket for each power of 2 nanoseconds.
+// Counters are split into shards, and each thread updates only its own shard (threads share shards only if there are more threads than shards),
+// so recording never contends between threads; snapshot() sums all shards.
+// Stats belong to a tracker object and are not moved with its objects.
+class tracker_stats
+{
+    using clock = std::chrono::steady_clock;
+    using clock_time = clock::time_point;
+
+public:
+
+    using size_type = std::size_t;
+
+    static constexpr size_type bucket_count = 32;
+    static constexpr size_type shard_count = 8;
+
+    // Stats of one operation.
+    struct operation_stats
+    {
+        std::uint64_t count = 0;
+        std::uint64_t total_nanoseconds = 0;
+
+        // Number of operations that took at least 2^(i - 1) and less than 2^i nanoseconds (and under 1 nanosecond for bucket 0),
+        // with the last bucket also counting any longer operations.
+        std::array<std::uint64_t, bucket_count> histogram{};
+    };
+
+    // Stats of all operations.
+    struct snapshot_type
+    {
+        std::array<operation_stats, tracker_operation_count> operations{};
+        size_type max_size = 0;
+
+        operation_stats const & operator[](tracker_operation an_operation) const { return operations[static_cast<size_type>(an_operation)]; }
+    };
+
+    // Records the time since it started when destroyed. Moveable but not copyable.
+    class timer
+    {
+    public:
+
+        timer(timer const &) = delete;
+        timer & operator=(timer const &) = delete;
+        timer(timer && rhs)
+            : stats_{rhs.stats_}
+            , operation_{rhs.operation_}
+            , start_{rhs.start_}
+        {
+            rhs.stats_ = nullptr;
+        }
+        timer & operator=(timer &&) = delete;
+
+        ~timer()
+        {
+            if (stats_)
+            {
+                auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_).count();
+                stats_->record(operation_, static_cast<std::uint64_t>(elapsed));
+            }
+        }
+
+    private:
+
+        friend class tracker_stats;
+
+        timer(tracker_stats * a_stats, tracker_operation an_operation)
+            : stats_{a_stats}
+            , operation_{an_operation}
+            , start_{clock::now()}
+        {
+        }
+
+        tracker_stats * stats_ = nullptr;
+        tracker_operation operation_ = tracker_operation::make;
+        clock_time start_{};
+    };
+
+    tracker_stats()
+        : shards_{new shard[shard_count]}
+    {
+    }
+
+    // Not copyable or moveable, since timers refer to the stats.
+    tracker_stats(tracker_stats const &) = delete;
+    tracker_stats & operator=(tracker_stats const &) = delete;
+
+    timer start(tracker_operation an_operation) { return timer{this, an_operation}; }
+
+    void record_size(size_type a_size)
+    {
+        auto && max_size = own_shard().max_size;
+        size_type old_size = max_size.load(std::memory_order_relaxed);
+        while (old_size < a_size and not max_size.compare_exchange_weak(old_size, a_size, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    snapshot_type snapshot() const
+    {
+        snapshot_type a_snapshot{};
+        for (size_type s = 0; s != shard_count; ++s)
+        {
+            shard const & a_shard = shards_[s];
+            for (size_type o = 0; o != tracker_operation_count; ++o)
+            {
+                auto && counters = a_shard.operations[o];
+                auto && stats = a_snapshot.operations[o];
+                stats.count += counters.count.load(std::memory_order_relaxed);
+                stats.total_nanoseconds += counters.total_nanoseconds.load(std::memory_order_relaxed);
+                for (size_type b = 0; b != bucket_count; ++b)
+                {
+                    stats.histogram[b] += counters.histogram[b].load(std::memory_order_relaxed);
+                }
+            }
+            a_snapshot.max_size = std::max(a_snapshot.max_size, a_shard.max_size.load(std::memory_order_relaxed));
+        }
+        return a_snapshot;
+    }
+
+private:
+
+    struct operation_counters
+    {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> total_nanoseconds{0};
+        std::array<std::atomic<std::uint64_t>, bucket_count> histogram{};
+    };
+
+    // Counters updated by the threads assigned to the shard.
+    // Note: padding keeps shards in separate cache lines.
+    struct shard
+    {
+        std::array<operation_counters, tracker_operation_count> operations{};
+        std::atomic<size_type> max_size{0};
+        char padding[64];
+    };
+
+    // Shard of the calling thread, which threads are assigned to in turn.
+    shard & own_shard()
+    {
+        static std::atomic<size_type> next{0};
+        thread_local size_type const index = next++ % shard_count;
+        return shards_[index];
+    }
+
+    void record(tracker_operation an_operation, std::uint64_t a_nanoseconds)
+    {
+        auto && counters = own_shard().operations[static_cast<size_type>(an_operation)];
+        counters.count.fetch_add(1, std::memory_order_relaxed);
+        counters.total_nanoseconds.fetch_add(a_nanoseconds, std::memory_order_relaxed);
+        size_type bucket = 0;
+        while (a_nanoseconds != 0 and bucket + 1 != bucket_count)
+        {
+            a_nanoseconds >>= 1;
+            ++bucket;
+        }
+        counters.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<shard[]> shards_;
+};
+
+// Storage for a tracker's stats policy.
+// An empty policy (i.e., no_stats) takes no space, and has no state, so each call uses a new instance.
+template <typename Stats_T, bool = std::is_empty<Stats_T>::value>
+class stats_holder
+{
+public:
+
+    Stats_T & stats_policy() { return *stats_policy_; }
+    Stats_T const & stats_policy() const { return *stats_policy_; }
+
+protected:
+
+    // Stats are not moved with the tracker (see tracker_stats), so a tracker made by moving starts new stats.
+    stats_holder() = default;
+    ~stats_holder() = default;
+
+private:
+
+    // Note: held by pointer so the policy need not be moveable.
+    std::unique_ptr<Stats_T> stats_policy_{new Stats_T{}};
+};
+
+template <typename Stats_T>
+class stats_holder<Stats_T, true>
+{
+public:
+
+    Stats_T stats_policy() const { return Stats_T{}; }
+
+protected:
+
+    stats_holder() = default;
+    ~stats_holder() = default;
+};
+
+}
+
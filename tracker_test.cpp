@@ -1,16 +1,103 @@
 #define CATCH_CONFIG_MAIN
 
+#include "async_tracker.hpp"
+#include "concurrent_tracker.hpp"
+#include "event_publisher.hpp"
+#include "fixed_tracker.hpp"
+#include "flat_hash_set.hpp"
+#include "flat_set.hpp"
+#include "intrusive_list.hpp"
+#include "keyed_vector.hpp"
+#include "mpsc_ring.hpp"
+#include "object_pool.hpp"
+#include "owning_tracker.hpp"
+#include "partitioned_vector.hpp"
+#include "slot_map.hpp"
+#include "small_vector.hpp"
+#include "soa_tracker.hpp"
+#include "thread_pool.hpp"
 #include "tracker.hpp"
+#include "tracker_archive.hpp"
+#include "unordered_vector.hpp"
+#include "work_stealing_pool.hpp"
 
 #include <catch2/catch.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <iterator>
+#include <new>
 #include <set>
+#include <sstream>
+#include <stdexcept>
 #include <memory>
+#include <thread>
 #include <vector>
 
+// Count allocations made by each thread, so tests can check that operations do not allocate.
+// Note: per thread so allocations by pools used in other tests are not counted.
+thread_local std::size_t allocation_count = 0;
+
+void * operator new(std::size_t a_size)
+{
+    ++allocation_count;
+    if (void * memory = std::malloc(a_size ? a_size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void * a_memory) noexcept
+{
+    std::free(a_memory);
+}
+
+void operator delete(void * a_memory, std::size_t) noexcept
+{
+    std::free(a_memory);
+}
+
+// Note: the array and nothrow forms are replaced too so every allocation is paired with the same deallocation (which sanitizers check).
+void * operator new(std::size_t a_size, std::nothrow_t const &) noexcept
+{
+    ++allocation_count;
+    return std::malloc(a_size ? a_size : 1);
+}
+
+void operator delete(void * a_memory, std::nothrow_t const &) noexcept
+{
+    std::free(a_memory);
+}
+
+void * operator new[](std::size_t a_size)
+{
+    return operator new(a_size);
+}
+
+void * operator new[](std::size_t a_size, std::nothrow_t const & a_nothrow) noexcept
+{
+    return operator new(a_size, a_nothrow);
+}
+
+void operator delete[](void * a_memory, std::nothrow_t const &) noexcept
+{
+    std::free(a_memory);
+}
+
+void operator delete[](void * a_memory) noexcept
+{
+    std::free(a_memory);
+}
+
+void operator delete[](void * a_memory, std::size_t) noexcept
+{
+    std::free(a_memory);
+}
+
 namespace wade {
 
 namespace {
@@ -34,10 +121,10 @@ struct mock_tracker
     std::size_t did_detach_count = 0;
 };
 
-// Define trackers with custom containers.
-#define DEFINE_MOCK_TRACKER_WITH_CONTAINER(TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE) \
+// Define trackers with custom containers and allocators.
+#define DEFINE_MOCK_TRACKER(TRACKER_TYPE, TRACKED_TYPE, ...) \
     struct TRACKER_TYPE \
-        : public TRACKER_WITH_CONTAINER(TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE) \
+        : public __VA_ARGS__ \
     { \
         void did_make(TRACKED_TYPE &) { ++did_make_count; } \
         void did_attach(TRACKED_TYPE &) { ++did_attach_count; } \
@@ -46,12 +133,224 @@ struct mock_tracker
         std::size_t did_attach_count = 0; \
         std::size_t did_detach_count = 0; \
     };
+#define DEFINE_MOCK_TRACKER_WITH_CONTAINER(TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE) \
+    DEFINE_MOCK_TRACKER(TRACKER_TYPE, TRACKED_TYPE, TRACKER_WITH_CONTAINER(TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE))
+#define DEFINE_MOCK_TRACKER_WITH_ALLOCATOR(TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE, ALLOCATOR_TYPE) \
+    DEFINE_MOCK_TRACKER(TRACKER_TYPE, TRACKED_TYPE, TRACKER_WITH_ALLOCATOR(TRACKER_TYPE, TRACKED_TYPE, CONTAINER_TYPE, ALLOCATOR_TYPE))
 
 DEFINE_MOCK_TRACKER_WITH_CONTAINER(mock_tracker_with_vector, test_type, std::vector)
 DEFINE_MOCK_TRACKER_WITH_CONTAINER(mock_tracker_with_set, test_type, std::set)
-//DEFINE_MOCK_TRACKER_WITH_CONTAINER(mock_tracker_with_flat_set, test_type, boost::container::flat_set)
+DEFINE_MOCK_TRACKER_WITH_CONTAINER(mock_tracker_with_flat_hash_set, test_type, wade::flat_hash_set)
+DEFINE_MOCK_TRACKER_WITH_CONTAINER(mock_tracker_with_intrusive_list, test_type, wade::intrusive_list)
+DEFINE_MOCK_TRACKER_WITH_CONTAINER(mock_tracker_with_unordered_vector, test_type, wade::unordered_vector)
+DEFINE_MOCK_TRACKER_WITH_CONTAINER(mock_tracker_with_slot_map, test_type, wade::slot_map)
+DEFINE_MOCK_TRACKER_WITH_CONTAINER(mock_tracker_with_small_vector, test_type, wade::small_vector)
+DEFINE_MOCK_TRACKER_WITH_CONTAINER(mock_tracker_with_flat_set, test_type, wade::flat_set)
+DEFINE_MOCK_TRACKER_WITH_ALLOCATOR(mock_tracker_with_pool, test_type, std::vector, wade::pool_allocator)
+DEFINE_MOCK_TRACKER(mock_tracker_with_stats, test_type, wade::tracker<mock_tracker_with_stats, test_type, std::vector<test_type *>, std::allocator<test_type>, wade::tracker_stats>)
+DEFINE_MOCK_TRACKER(mock_compact_tracker, test_type, wade::tracker<mock_compact_tracker, test_type, std::vector<test_type *>, std::allocator<test_type>, wade::no_stats, wade::compact_link, wade::dirty_list>)
+DEFINE_MOCK_TRACKER(mock_stable_tracker, test_type, wade::tracker<mock_stable_tracker, test_type, std::vector<test_type *>, std::allocator<test_type>, wade::no_stats, wade::stable_link>)
+DEFINE_MOCK_TRACKER(mock_dirty_tracker, test_type, wade::tracker<mock_dirty_tracker, test_type, std::vector<test_type *>, std::allocator<test_type>, wade::no_stats, wade::pointer_link, wade::dirty_list>)
+DEFINE_MOCK_TRACKER(mock_fixed_tracker, test_type, wade::fixed_tracker<mock_fixed_tracker, test_type, 4096>)
+DEFINE_MOCK_TRACKER(mock_small_fixed_tracker, test_type, wade::fixed_tracker<mock_small_fixed_tracker, test_type, 4, wade::dirty_list>)
+
+// Define tracker that is notified of bulk operations in batches.
+struct mock_tracker_with_batches
+    : public wade::tracker<mock_tracker_with_batches, test_type>
+{
+    void did_make(test_type &) { ++did_make_count; }
+    void did_attach(test_type &) { ++did_attach_count; }
+    void did_detach(test_type &) { ++did_detach_count; }
+    void did_make_batch(tracked_span a_objects) { did_make_batch_sizes.push_back(a_objects.size()); }
+    void did_attach_batch(tracked_span a_objects) { did_attach_batch_sizes.push_back(a_objects.size()); }
+    void did_detach_batch(tracked_span a_objects)
+    {
+        // Objects should already be detached when notified.
+        for (auto && a_tracked : a_objects)
+        {
+            REQUIRE(static_cast<trackable *>(a_tracked)->is_detached());
+        }
+        did_detach_batch_sizes.push_back(a_objects.size());
+    }
+
+    std::size_t did_make_count = 0;
+    std::size_t did_attach_count = 0;
+    std::size_t did_detach_count = 0;
+    std::vector<std::size_t> did_make_batch_sizes{};
+    std::vector<std::size_t> did_attach_batch_sizes{};
+    std::vector<std::size_t> did_detach_batch_sizes{};
+};
+
+// Define concurrent tracker, which counts atomically since it is notified from multiple threads.
+template <typename Container_T>
+struct basic_mock_concurrent_tracker
+    : public wade::concurrent_tracker<basic_mock_concurrent_tracker<Container_T>, test_type, Container_T>
+{
+    void did_make(test_type &) { ++did_make_count; }
+    void did_attach(test_type &) { ++did_attach_count; }
+    void did_detach(test_type &) { ++did_detach_count; }
+
+    std::atomic<std::size_t> did_make_count{0};
+    std::atomic<std::size_t> did_attach_count{0};
+    std::atomic<std::size_t> did_detach_count{0};
+};
+using mock_concurrent_tracker = basic_mock_concurrent_tracker<wade::unordered_vector<test_type *> >;
+using mock_concurrent_tracker_with_vector = basic_mock_concurrent_tracker<std::vector<test_type *> >;
+
+// Define tracker that stores the fields of test_type (and another) as columns.
+struct mock_soa_tracker
+    : public wade::soa_tracker<mock_soa_tracker, std::int64_t, double>
+{
+    void did_make(handle & a_handle) { ++did_make_count; REQUIRE(a_handle.my_tracker() == this); }
+    void did_detach(handle & a_handle) { ++did_detach_count; detached_sum += a_handle.get<0>(); }
+
+    std::size_t did_make_count = 0;
+    std::size_t did_detach_count = 0;
+    std::int64_t detached_sum = 0;
+};
+
+// Define SoA tracker that defines none of the methods.
+struct mock_soa_tracker_without_methods
+    : public wade::soa_tracker<mock_soa_tracker_without_methods, std::int64_t>
+{
+};
+
+// Define tracker that indexes its objects by an id, which unlike value is never changed while attached.
+struct keyed_type
+    : public test_type
+{
+    keyed_type() = default;
+    explicit keyed_type(std::int64_t a_value) : test_type{a_value}, id{a_value} {}
+
+    std::int64_t id = 0;
+};
+struct id_of
+{
+    std::int64_t operator()(keyed_type const & a_tracked) const { return a_tracked.id; }
+};
+DEFINE_MOCK_TRACKER(mock_keyed_tracker, keyed_type, wade::tracker<mock_keyed_tracker, keyed_type, wade::keyed_vector<keyed_type *, id_of> >)
+
+// Define tracker that partitions its objects by value modulo 3.
+struct partition_of
+{
+    std::size_t operator()(test_type const & a_tracked) const { return static_cast<std::size_t>(a_tracked.value) % 3; }
+};
+DEFINE_MOCK_TRACKER(mock_partitioned_tracker, test_type, wade::tracker<mock_partitioned_tracker, test_type, wade::partitioned_vector<test_type *, partition_of, 3> >)
+
+// Define tracker that stores its objects in place, in chunks of 64.
+struct mock_owning_tracker
+    : public wade::owning_tracker<mock_owning_tracker, std::int64_t, 64>
+{
+    void did_make(std::int64_t &) { ++did_make_count; }
+    void did_detach(std::int64_t & a_value) { ++did_detach_count; detached_sum += a_value; }
+
+    std::size_t did_make_count = 0;
+    std::size_t did_detach_count = 0;
+    std::int64_t detached_sum = 0;
+};
+
+// Define tracker that is notified asynchronously, which records the order of methods in each object's value.
+struct mock_async_tracker
+    : public wade::async_tracker<mock_async_tracker, test_type>
+{
+    explicit mock_async_tracker(wade::work_stealing_pool & a_pool)
+        : async_tracker{a_pool}
+    {
+    }
+    ~mock_async_tracker()
+    {
+        flush();
+    }
+
+    void did_make(test_type & a_tracked) { record(a_tracked, 1); ++did_make_count; }
+    void did_attach(test_type & a_tracked) { record(a_tracked, 2); ++did_attach_count; }
+    void did_detach(test_type & a_tracked) { record(a_tracked, 3); ++did_detach_count; }
+
+    // Append a digit to the value, which is safe without a lock since methods for each object are called one at a time.
+    void record(test_type & a_tracked, std::int64_t a_digit) { a_tracked.value = a_tracked.value * 10 + a_digit; }
+
+    std::atomic<std::size_t> did_make_count{0};
+    std::atomic<std::size_t> did_attach_count{0};
+    std::atomic<std::size_t> did_detach_count{0};
+};
+
+// Define asynchronous tracker that only defines some methods.
+struct mock_partial_async_tracker
+    : public wade::async_tracker<mock_partial_async_tracker, test_type>
+{
+    explicit mock_partial_async_tracker(wade::work_stealing_pool & a_pool)
+        : async_tracker{a_pool}
+    {
+    }
+    ~mock_partial_async_tracker()
+    {
+        flush();
+    }
 
+    void did_attach(test_type &) { ++did_attach_count; }
+
+    std::atomic<std::size_t> did_attach_count{0};
+};
+
+// Define asynchronous tracker that only defines batch methods, which counts the objects of each.
+struct mock_batch_async_tracker
+    : public wade::async_tracker<mock_batch_async_tracker, test_type>
+{
+    explicit mock_batch_async_tracker(wade::work_stealing_pool & a_pool)
+        : async_tracker{a_pool}
+    {
+    }
+    ~mock_batch_async_tracker()
+    {
+        flush();
+    }
+
+    void did_make_batch(tracked_span a_objects) { did_make_count += a_objects.size(); }
+    void did_attach_batch(tracked_span a_objects) { did_attach_count += a_objects.size(); }
+    void did_detach_batch(tracked_span a_objects) { did_detach_count += a_objects.size(); ++did_detach_batch_count; }
+
+    std::atomic<std::size_t> did_make_count{0};
+    std::atomic<std::size_t> did_attach_count{0};
+    std::atomic<std::size_t> did_detach_count{0};
+    std::size_t did_detach_batch_count = 0;
+};
+
+// Define trackers that publish events instead of counting.
+struct mock_publishing_tracker
+    : public wade::event_publisher<test_type, 64>
+    , public wade::tracker<mock_publishing_tracker, test_type>
+{
+};
+struct mock_publishing_concurrent_tracker
+    : public wade::event_publisher<test_type, 64>
+    , public wade::concurrent_tracker<mock_publishing_concurrent_tracker, test_type>
+{
+};
+struct mock_dropping_tracker
+    : public wade::event_publisher<test_type, 64, wade::drop_when_full>
+    , public wade::tracker<mock_dropping_tracker, test_type>
+{
+};
+
+// Define trackers that define only some (or none) of the methods.
+struct mock_tracker_without_methods
+    : public wade::tracker<mock_tracker_without_methods, test_type>
+{
+};
+struct mock_tracker_with_did_detach
+    : public wade::tracker<mock_tracker_with_did_detach, test_type, wade::unordered_vector<test_type *> >
+{
+    void did_detach(test_type &) { ++did_detach_count; }
+    std::size_t did_detach_count = 0;
+};
+struct mock_concurrent_tracker_without_methods
+    : public wade::concurrent_tracker<mock_concurrent_tracker_without_methods, test_type>
+{
+};
+
+#undef DEFINE_MOCK_TRACKER_WITH_ALLOCATOR
 #undef DEFINE_MOCK_TRACKER_WITH_CONTAINER
+#undef DEFINE_MOCK_TRACKER
 
 template <typename Tracker_T>
 void run_test()
@@ -282,21 +581,2176 @@ void run_test()
 
 }
 
+template <typename Tracker_T>
+void run_bulk_test()
+{
+    // Make a number of instances with the same arguments.
+    Tracker_T tracker{};
+    std::size_t const size = 10;
+    std::int64_t const value = 7;
+    auto && owner = tracker.make_n(size, value);
+    REQUIRE(owner.size() == size);
+    REQUIRE(tracker.tracked_objects().size() == size);
+    REQUIRE(tracker.did_make_count == size);
+    for (auto && instance : owner)
+    {
+        REQUIRE(tracker.is_attached(instance));
+        REQUIRE(instance->value == value);
+    }
+
+    // Detach every other instance, including null and repeated instances, which should be skipped.
+    using trackable = typename Tracker_T::trackable;
+    std::vector<trackable *> odd{nullptr};
+    for (std::size_t i = 1; i < size; i += 2)
+    {
+        odd.push_back(owner[i].get());
+        odd.push_back(owner[i].get());
+    }
+    REQUIRE(tracker.detach(std::begin(odd), std::end(odd)) == size / 2);
+    REQUIRE(tracker.tracked_objects().size() == size / 2);
+    REQUIRE(tracker.did_detach_count == size / 2);
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        REQUIRE(tracker.is_attached(owner[i]) == (i % 2 == 0));
+    }
+
+    // Detaching the same instances again should do nothing.
+    REQUIRE(tracker.detach(std::begin(odd), std::end(odd)) == 0);
+    REQUIRE(tracker.did_detach_count == size / 2);
+
+    // Reattach all instances by their owning pointers, which should skip the already-attached instances.
+    REQUIRE(tracker.attach(std::begin(owner), std::end(owner)) == size / 2);
+    REQUIRE(tracker.tracked_objects().size() == size);
+    REQUIRE(tracker.did_attach_count == size / 2);
+
+    // Attaching a range to another tracker should move instances from the first tracker.
+    Tracker_T tracker_2{};
+    REQUIRE(tracker_2.attach(std::begin(owner), std::begin(owner) + 3) == 3);
+    REQUIRE(tracker.tracked_objects().size() == size - 3);
+    REQUIRE(tracker_2.tracked_objects().size() == 3);
+    REQUIRE(tracker.did_detach_count == size / 2 + 3);
+    REQUIRE(tracker_2.did_attach_count == 3);
+
+    // Detach all instances by their owning pointers, while the remaining instances are still accessible.
+    REQUIRE(tracker.detach(std::begin(owner), std::end(owner)) == size - 3);
+    REQUIRE(tracker.tracked_objects().empty());
+    REQUIRE(tracker_2.tracked_objects().size() == 3);
+    for (auto && instance : tracker_2.tracked_objects())
+    {
+        REQUIRE(instance->value == value);
+    }
+}
+
+template <typename Tracker_T>
+void run_deferred_test()
+{
+    // Make instances whose values are their order of making.
+    Tracker_T tracker{};
+    std::size_t const size = 10;
+    auto && owner = tracker.make_n(size);
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner[i]->value = static_cast<std::int64_t>(i);
+    }
+
+    {
+        // Delete odd instances while iterating, which should leave null values in place.
+        auto && deferral = tracker.defer_detach();
+        REQUIRE(tracker.is_deferring());
+        std::size_t visited = 0;
+        for (auto && instance : tracker.tracked_objects())
+        {
+            ++visited;
+            if (instance and instance->value % 2 == 1)
+            {
+                owner[static_cast<std::size_t>(instance->value)].reset();
+            }
+        }
+        REQUIRE(visited == size);
+        REQUIRE(tracker.tracked_objects().size() == size);
+        REQUIRE(tracker.did_detach_count == size / 2);
+
+        // Nested deferrals should not compact.
+        {
+            auto && nested = tracker.defer_detach();
+            REQUIRE(tracker.detach(owner[0]));
+            auto && moved = std::move(nested);
+            (void)moved;
+        }
+        REQUIRE(tracker.is_deferring());
+        REQUIRE(tracker.tracked_objects().size() == size);
+
+        // Detaching ranges or all instances should also leave null values in place.
+        REQUIRE(tracker.detach(std::begin(owner), std::begin(owner) + 3) == 1);
+        REQUIRE(tracker.tracked_objects().size() == size);
+        (void)deferral;
+    }
+
+    // Ending the deferral should erase all null values.
+    REQUIRE(not tracker.is_deferring());
+    REQUIRE(tracker.tracked_objects().size() == size / 2 - 2);
+    for (auto && instance : tracker.tracked_objects())
+    {
+        REQUIRE(instance);
+        REQUIRE(tracker.is_attached(owner[static_cast<std::size_t>(instance->value)]));
+    }
+
+    // Remaining instances should detach normally (which checks containers' hooks were updated).
+    {
+        auto && deferral = tracker.defer_detach();
+        tracker.detach_all();
+        REQUIRE(tracker.tracked_objects().size() == size / 2 - 2);
+        REQUIRE(std::all_of(std::begin(tracker.tracked_objects()), std::end(tracker.tracked_objects()), [](test_type * a_tracked) { return a_tracked == nullptr; }));
+        REQUIRE(std::none_of(std::begin(owner), std::end(owner), [&tracker](typename Tracker_T::trackable_ptr const & instance) { return tracker.is_attached(instance); }));
+        (void)deferral;
+    }
+    REQUIRE(tracker.tracked_objects().empty());
+    REQUIRE(tracker.did_detach_count == size);
+    tracker.attach(std::begin(owner), std::end(owner));
+    for (auto && instance : owner)
+    {
+        REQUIRE((not instance or instance->detach()));
+    }
+    REQUIRE(tracker.tracked_objects().empty());
+
+    // Deferring without detaching should do nothing.
+    {
+        auto && deferral = tracker.defer_detach();
+        (void)deferral;
+    }
+    REQUIRE(tracker.tracked_objects().empty());
+}
+
+template <typename Tracker_T>
+void run_chunk_test()
+{
+    // Make enough instances for multiple chunks, with values that are their order of making.
+    Tracker_T tracker{};
+    std::size_t const size = Tracker_T::chunk_size * 2 + 3;
+    auto && owner = tracker.make_n(size);
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner[i]->value = static_cast<std::int64_t>(i);
+    }
+    std::int64_t const sum = static_cast<std::int64_t>(size * (size - 1) / 2);
+
+    // Visiting each instance or each chunk should visit all instances once.
+    std::int64_t each_sum = 0;
+    tracker.for_each([&](test_type & a_tracked) { each_sum += a_tracked.value; });
+    REQUIRE(each_sum == sum);
+    std::int64_t chunk_sum = 0;
+    std::size_t chunk_count = 0;
+    tracker.for_each_chunk([&](typename Tracker_T::tracked_span a_chunk)
+    {
+        REQUIRE(a_chunk.size() == std::min(Tracker_T::chunk_size, size - chunk_count * Tracker_T::chunk_size));
+        for (auto && a_tracked : a_chunk)
+        {
+            chunk_sum += a_tracked->value;
+        }
+        ++chunk_count;
+    });
+    REQUIRE(chunk_sum == sum);
+    REQUIRE(chunk_count == 3);
+
+    // Visiting should skip instances detached while deferring.
+    auto && deferral = tracker.defer_detach();
+    owner[1].reset();
+    each_sum = 0;
+    tracker.for_each([&](test_type & a_tracked) { each_sum += a_tracked.value; });
+    REQUIRE(each_sum == sum - 1);
+    (void)deferral;
+}
+
+template <typename Tracker_T>
+void run_parallel_test()
+{
+    // Update instances in parallel, and count visits atomically since Catch2 is not thread-safe.
+    wade::thread_pool pool{3};
+    Tracker_T tracker{};
+    std::size_t const size = Tracker_T::chunk_size * 8 + 5;
+    auto && owner = tracker.make_n(size);
+    std::atomic<std::size_t> visited{0};
+    tracker.for_each(pool, [&](test_type & a_tracked)
+    {
+        ++a_tracked.value;
+        ++visited;
+    });
+    REQUIRE(visited == size);
+    std::atomic<std::size_t> chunked{0};
+    tracker.for_each_chunk(pool, [&](typename Tracker_T::tracked_span a_chunk)
+    {
+        for (auto && a_tracked : a_chunk)
+        {
+            ++a_tracked->value;
+        }
+        chunked += a_chunk.size();
+    });
+    REQUIRE(chunked == size);
+    for (auto && instance : owner)
+    {
+        REQUIRE(instance->value == 2);
+    }
+
+    // An empty tracker should not call the function.
+    Tracker_T tracker_2{};
+    tracker_2.for_each(pool, [&](test_type &) { ++visited; });
+    REQUIRE(visited == size);
+}
+
+template <typename Tracker_T>
+void run_owned_test()
+{
+    // Make owned instances, which the tracker keeps even when detached.
+    Tracker_T tracker{};
+    std::size_t const size = 10;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        auto && instance = tracker.make_owned();
+        REQUIRE(instance);
+        instance->value = static_cast<std::int64_t>(i);
+        REQUIRE(tracker.is_attached(instance));
+    }
+    REQUIRE(tracker.owned_size() == size);
+    REQUIRE(tracker.tracked_objects().size() == size);
+    REQUIRE(tracker.did_make_count == size);
+
+    // Detach one owned instance, and move another to a second tracker.
+    using trackable = typename Tracker_T::trackable;
+    auto && detached = *static_cast<trackable *>(*std::begin(tracker.tracked_objects()));
+    REQUIRE(detached.detach());
+    Tracker_T tracker_2{};
+    auto && moved = *static_cast<trackable *>(*std::begin(tracker.tracked_objects()));
+    REQUIRE(tracker_2.attach(&moved));
+    REQUIRE(tracker.owned_size() == size);
+
+    // Destroying all should detach remaining instances, then delete all owned instances, including the moved one.
+    auto && instance = tracker.make();
+    tracker.destroy_all();
+    REQUIRE(tracker.owned_size() == 0);
+    REQUIRE(tracker.tracked_objects().empty());
+    REQUIRE(tracker.did_detach_count == size + 1);
+    REQUIRE(tracker_2.tracked_objects().empty());
+    REQUIRE(tracker_2.did_detach_count == 1);
+    REQUIRE(instance->is_detached());
+
+    // Destroying the tracker should delete owned instances too.
+    Tracker_T tracker_3{};
+    tracker_3.make_owned();
+    {
+        Tracker_T tracker_4{std::move(tracker_3)};
+        REQUIRE(tracker_4.owned_size() == 1);
+        REQUIRE(tracker_4.tracked_objects().size() == 1);
+    }
+}
+
 // Run the same tests with default and custom containers, which should all behave the same.
 
 TEST_CASE("Default tracker", "[single-file]")
 {
     run_test<mock_tracker>();
+    run_bulk_test<mock_tracker>();
+    run_owned_test<mock_tracker>();
+    run_deferred_test<mock_tracker>();
+    run_chunk_test<mock_tracker>();
+    run_parallel_test<mock_tracker>();
 }
 
 TEST_CASE("Tracker with vector", "[single-file]")
 {
     run_test<mock_tracker_with_vector>();
+    run_bulk_test<mock_tracker_with_vector>();
+    run_owned_test<mock_tracker_with_vector>();
+    run_deferred_test<mock_tracker_with_vector>();
+    run_chunk_test<mock_tracker_with_vector>();
+    run_parallel_test<mock_tracker_with_vector>();
 }
 
 TEST_CASE("Tracker with set", "[single-file]")
 {
     run_test<mock_tracker_with_set>();
+    run_bulk_test<mock_tracker_with_set>();
+    run_owned_test<mock_tracker_with_set>();
+
+    // Chunks should be copied since a set's objects are not contiguous.
+    mock_tracker_with_set tracker{};
+    auto && owner = tracker.make_n(mock_tracker_with_set::chunk_size + 1);
+    std::vector<std::size_t> chunk_sizes{};
+    tracker.for_each_chunk([&](mock_tracker_with_set::tracked_span a_chunk) { chunk_sizes.push_back(a_chunk.size()); });
+    REQUIRE(chunk_sizes == (std::vector<std::size_t>{mock_tracker_with_set::chunk_size, 1}));
+    std::size_t visited = 0;
+    tracker.for_each([&](test_type &) { ++visited; });
+    REQUIRE(visited == owner.size());
+}
+
+TEST_CASE("Tracker with flat hash set", "[single-file]")
+{
+    run_test<mock_tracker_with_flat_hash_set>();
+    run_bulk_test<mock_tracker_with_flat_hash_set>();
+    run_owned_test<mock_tracker_with_flat_hash_set>();
+}
+
+TEST_CASE("Flat hash set finds values after erasing", "[single-file]")
+{
+    // Insert and erase in a pseudo-random order (with collisions and wrapping around), checking against std::set.
+    std::vector<int> values(1000);
+    wade::flat_hash_set<int *> a_set{};
+    std::set<int *> expected{};
+    std::uint64_t state = 1;
+    for (std::size_t step = 0; step != 20000; ++step)
+    {
+        state = state * UINT64_C(6364136223846793005) + 1;
+        int * a_value = &values[static_cast<std::size_t>(state >> 33) % values.size()];
+        if ((state >> 32) & 1)
+        {
+            REQUIRE(a_set.insert(a_value).second == expected.insert(a_value).second);
+        }
+        else
+        {
+            REQUIRE(a_set.erase(a_value) == expected.erase(a_value));
+        }
+        REQUIRE(a_set.size() == expected.size());
+    }
+
+    // Every value should be found if and only if it is expected, and iteration should visit each one once.
+    for (auto && a_value : values)
+    {
+        REQUIRE(a_set.count(&a_value) == expected.count(&a_value));
+    }
+    std::set<int *> visited(std::begin(a_set), std::end(a_set));
+    REQUIRE(visited == expected);
+    REQUIRE(static_cast<std::size_t>(std::distance(std::begin(a_set), std::end(a_set))) == expected.size());
+
+    // Reserving should keep values, and clearing should leave no values.
+    a_set.reserve(values.size() * 4);
+    REQUIRE(a_set.capacity() >= values.size() * 4);
+    REQUIRE(std::set<int *>(std::begin(a_set), std::end(a_set)) == expected);
+
+    // Moving should leave an empty set with no table that can be reused.
+    wade::flat_hash_set<int *> moved{std::move(a_set)};
+    REQUIRE(std::set<int *>(std::begin(moved), std::end(moved)) == expected);
+    REQUIRE(a_set.size() == 0);
+    REQUIRE(a_set.empty());
+    REQUIRE(a_set.capacity() == 0);
+    REQUIRE(std::begin(a_set) == std::end(a_set));
+    for (auto && a_value : values)
+    {
+        REQUIRE(a_set.insert(&a_value).second);
+    }
+    REQUIRE(a_set.size() == values.size());
+    for (auto && a_value : values)
+    {
+        REQUIRE(a_set.count(&a_value) == 1);
+    }
+    a_set = std::move(moved);
+    REQUIRE(a_set.size() == expected.size());
+    REQUIRE(moved.size() == 0);
+    REQUIRE(std::set<int *>(std::begin(a_set), std::end(a_set)) == expected);
+    a_set.clear();
+    REQUIRE(a_set.empty());
+    REQUIRE(std::begin(a_set) == std::end(a_set));
+    REQUIRE(a_set.find(&values[0]) == std::end(a_set));
+}
+
+TEST_CASE("Tracker with flat set", "[single-file]")
+{
+    run_test<mock_tracker_with_flat_set>();
+    run_bulk_test<mock_tracker_with_flat_set>();
+    run_owned_test<mock_tracker_with_flat_set>();
+    run_parallel_test<mock_tracker_with_flat_set>();
+}
+
+TEST_CASE("Flat set finds values in its tail and keeps them sorted", "[single-file]")
+{
+    // Insert and erase in a pseudo-random order (with short and long tails), checking against std::set.
+    std::vector<int> values(1000);
+    wade::flat_set<int *> a_set{};
+    std::set<int *> expected{};
+    std::uint64_t state = 1;
+    for (std::size_t step = 0; step != 20000; ++step)
+    {
+        state = state * UINT64_C(6364136223846793005) + 1;
+        int * a_value = &values[static_cast<std::size_t>(state >> 33) % values.size()];
+        if (expected.count(a_value) == 0)
+        {
+            a_set.insert(std::end(a_set), a_value);
+            expected.insert(a_value);
+        }
+        else if ((state >> 32) & 1)
+        {
+            REQUIRE(a_set.erase(a_value) == expected.erase(a_value));
+        }
+        REQUIRE(a_set.size() == expected.size());
+        REQUIRE(a_set.count(a_value) == expected.count(a_value));
+
+        // Iterating should merge the tail into order.
+        if (step % 1000 == 0)
+        {
+            REQUIRE(std::equal(std::begin(a_set), std::end(a_set), std::begin(expected), std::end(expected)));
+        }
+    }
+    REQUIRE(std::equal(std::begin(a_set), std::end(a_set), std::begin(expected), std::end(expected)));
+
+    // Erasing should return the following value, and moving should leave an empty set.
+    int * const second = *std::next(std::begin(a_set));
+    REQUIRE(*a_set.erase(std::begin(a_set)) == second);
+    wade::flat_set<int *> moved{std::move(a_set)};
+    REQUIRE(moved.size() == expected.size() - 1);
+    REQUIRE(a_set.empty());
+    REQUIRE(std::begin(a_set) == std::end(a_set));
+    a_set.insert(&values[0]);
+    REQUIRE(a_set.find(&values[0]) == std::begin(a_set));
+}
+
+TEST_CASE("Tracker with keyed vector", "[single-file]")
+{
+    run_test<mock_keyed_tracker>();
+    run_bulk_test<mock_keyed_tracker>();
+    run_owned_test<mock_keyed_tracker>();
+    run_deferred_test<mock_keyed_tracker>();
+    run_chunk_test<mock_keyed_tracker>();
+}
+
+TEST_CASE("Keyed vector finds objects by key", "[single-file]")
+{
+    mock_keyed_tracker tracker{};
+    std::vector<mock_keyed_tracker::trackable_ptr> owner{};
+    std::size_t const size = 10;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner.push_back(tracker.make(static_cast<std::int64_t>(i)));
+    }
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        REQUIRE(tracker.find_by_key(static_cast<std::int64_t>(i)) == owner[i].get());
+    }
+    REQUIRE(tracker.find_by_key(std::int64_t{-1}) == nullptr);
+
+    // Detaching should remove the key, including while deferred.
+    owner[3]->detach();
+    REQUIRE(tracker.find_by_key(std::int64_t{3}) == nullptr);
+    {
+        auto && deferral = tracker.defer_detach();
+        owner[4].reset();
+        REQUIRE(tracker.find_by_key(std::int64_t{4}) == nullptr);
+        REQUIRE(tracker.find_by_key(std::int64_t{9}) == owner[9].get());
+    }
+    REQUIRE(tracker.find_by_key(std::int64_t{9}) == owner[9].get());
+
+    // Copies share a key, which should be found until all of them are detached.
+    mock_keyed_tracker::trackable copy{*owner[5]};
+    owner[5]->detach();
+    REQUIRE(tracker.find_by_key(std::int64_t{5}) == &copy);
+    copy.detach();
+    REQUIRE(tracker.find_by_key(std::int64_t{5}) == nullptr);
+
+    // Moving the tracker should move the index.
+    mock_keyed_tracker tracker_2{std::move(tracker)};
+    REQUIRE(tracker.find_by_key(std::int64_t{7}) == nullptr);
+    REQUIRE(tracker_2.find_by_key(std::int64_t{7}) == owner[7].get());
+    tracker_2.detach_all();
+    REQUIRE(tracker_2.find_by_key(std::int64_t{7}) == nullptr);
+}
+
+TEST_CASE("Tracker with partitioned vector", "[single-file]")
+{
+    run_test<mock_partitioned_tracker>();
+    run_bulk_test<mock_partitioned_tracker>();
+    run_owned_test<mock_partitioned_tracker>();
+    run_deferred_test<mock_partitioned_tracker>();
+    run_chunk_test<mock_partitioned_tracker>();
+    run_parallel_test<mock_partitioned_tracker>();
+}
+
+TEST_CASE("Partitioned vector keeps objects in the partitions of their tags", "[single-file]")
+{
+    mock_partitioned_tracker tracker{};
+    std::vector<mock_partitioned_tracker::trackable_ptr> owner{};
+    std::size_t const size = 30;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner.push_back(tracker.make(static_cast<std::int64_t>(i)));
+    }
+
+    // Every partition should hold exactly the attached objects with its tag, each found where its hook says.
+    auto && require_partitioned = [&tracker, &owner]()
+    {
+        std::size_t count = 0;
+        for (std::size_t p = 0; p != 3; ++p)
+        {
+            for (auto && a_tracked : tracker.partition(p))
+            {
+                auto && instance = static_cast<mock_partitioned_tracker::trackable *>(a_tracked);
+                REQUIRE(partition_of{}(*instance) == p);
+                REQUIRE(instance->my_hook().partition == p);
+                REQUIRE(tracker.tracked_objects()[instance->my_hook().index] == a_tracked);
+                ++count;
+            }
+        }
+        REQUIRE(count == tracker.tracked_objects().size());
+        REQUIRE(count == static_cast<std::size_t>(std::count_if(std::begin(owner), std::end(owner),
+            [](mock_partitioned_tracker::trackable_ptr const & a_ptr) { return a_ptr and a_ptr->is_attached(); })));
+    };
+    require_partitioned();
+    REQUIRE(tracker.partition(0).size() == size / 3);
+
+    // Changing tags should move objects between partitions.
+    for (std::size_t i = 0; i != size; i += 2)
+    {
+        owner[i]->value += 1 + static_cast<std::int64_t>(i % 5);
+        tracker.repartition(*owner[i]);
+        require_partitioned();
+    }
+
+    // Detaching from any partition should keep the others intact, including while deferred.
+    owner[0]->detach();
+    owner[13].reset();
+    owner[29]->detach();
+    require_partitioned();
+    {
+        auto && deferral = tracker.defer_detach();
+        owner[7].reset();
+        owner[8]->detach();
+        owner[9]->value = 10;
+        tracker.repartition(*owner[9]);
+        owner.push_back(tracker.make(std::int64_t{2}));
+    }
+    require_partitioned();
+    REQUIRE(tracker.tracked_objects().size() == size + 1 - 5);
+
+    // A moved-from tracker should be empty and still partition the objects it makes.
+    mock_partitioned_tracker tracker_2{std::move(tracker)};
+    REQUIRE(tracker.tracked_objects().empty());
+    for (std::size_t p = 0; p != 3; ++p)
+    {
+        REQUIRE(tracker.partition(p).empty());
+    }
+    auto && instance = tracker.make(std::int64_t{1});
+    auto && other = tracker.make(std::int64_t{5});
+    REQUIRE(tracker.partition(0).empty());
+    REQUIRE(tracker.partition(1).size() == 1);
+    REQUIRE(tracker.partition(1)[0] == instance.get());
+    REQUIRE(tracker.partition(2).size() == 1);
+    REQUIRE(tracker.partition(2)[0] == other.get());
+    REQUIRE(tracker_2.tracked_objects().size() == size + 1 - 5);
+    instance.reset();
+    REQUIRE(tracker.partition(1).empty());
+    REQUIRE(tracker.tracked_objects().size() == 1);
+}
+
+TEST_CASE("Tracker with unordered vector", "[single-file]")
+{
+    run_test<mock_tracker_with_unordered_vector>();
+    run_bulk_test<mock_tracker_with_unordered_vector>();
+    run_owned_test<mock_tracker_with_unordered_vector>();
+    run_deferred_test<mock_tracker_with_unordered_vector>();
+    run_chunk_test<mock_tracker_with_unordered_vector>();
+    run_parallel_test<mock_tracker_with_unordered_vector>();
+}
+
+TEST_CASE("Unordered vector updates moved objects when detaching", "[single-file]")
+{
+    mock_tracker_with_unordered_vector tracker{};
+    std::vector<mock_tracker_with_unordered_vector::trackable_ptr> owner{};
+    std::size_t const size = 10;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner.push_back(tracker.make());
+    }
+
+    // Detach from the front, middle, and back, which each move a different object into the detached position.
+    owner[0]->detach();
+    owner[5]->detach();
+    owner[9].reset();
+    REQUIRE(tracker.tracked_objects().size() == size - 3);
+    REQUIRE(tracker.did_detach_count == 3);
+
+    // Every remaining object should be found where its hook says it is.
+    for (std::size_t i = 0; i != tracker.tracked_objects().size(); ++i)
+    {
+        auto && instance = static_cast<mock_tracker_with_unordered_vector::trackable *>(tracker.tracked_objects()[i]);
+        REQUIRE(instance->is_attached());
+        REQUIRE(instance->my_hook() == i);
+    }
+
+    // Detaching the rest in order should leave nothing behind.
+    owner.clear();
+    REQUIRE(tracker.tracked_objects().empty());
+    REQUIRE(tracker.did_detach_count == size);
+}
+
+TEST_CASE("Tracker with slot map", "[single-file]")
+{
+    run_test<mock_tracker_with_slot_map>();
+    run_bulk_test<mock_tracker_with_slot_map>();
+    run_owned_test<mock_tracker_with_slot_map>();
+    run_deferred_test<mock_tracker_with_slot_map>();
+    run_chunk_test<mock_tracker_with_slot_map>();
+    run_parallel_test<mock_tracker_with_slot_map>();
+}
+
+TEST_CASE("Slot map handles become stale when detached", "[single-file]")
+{
+    mock_tracker_with_slot_map tracker{};
+    auto && instance_1 = tracker.make();
+    auto && instance_2 = tracker.make();
+    auto && instance_3 = tracker.make();
+    auto && objects = tracker.tracked_objects();
+
+    // Handles should look up their own objects.
+    auto const handle_1 = instance_1->my_hook();
+    auto const handle_2 = instance_2->my_hook();
+    auto const handle_3 = instance_3->my_hook();
+    REQUIRE(objects.get(handle_1) == instance_1.get());
+    REQUIRE(objects.get(handle_2) == instance_2.get());
+    REQUIRE(objects.get(handle_3) == instance_3.get());
+    REQUIRE_FALSE(objects.contains({}));
+    REQUIRE(objects.get({}) == nullptr);
+
+    // Detaching moves the last object but does not change its handle.
+    instance_1->detach();
+    REQUIRE_FALSE(objects.contains(handle_1));
+    REQUIRE(objects.get(handle_1) == nullptr);
+    REQUIRE(objects.get(handle_2) == instance_2.get());
+    REQUIRE(objects.get(handle_3) == instance_3.get());
+    REQUIRE(instance_3->my_hook() == handle_3);
+
+    // Reusing a slot should not revive an old handle.
+    auto && instance_4 = tracker.make();
+    REQUIRE(instance_4->my_hook().index == handle_1.index);
+    REQUIRE(instance_4->my_hook() != handle_1);
+    REQUIRE(objects.get(handle_1) == nullptr);
+    REQUIRE(objects.get(instance_4->my_hook()) == instance_4.get());
+
+    // Deleting and detaching all objects should make every handle stale.
+    instance_2.reset();
+    REQUIRE(objects.get(handle_2) == nullptr);
+    tracker.detach_all();
+    REQUIRE(objects.empty());
+    REQUIRE(objects.get(handle_3) == nullptr);
+
+    // Slots freed by detach_all() should be reused.
+    tracker.attach(instance_3);
+    REQUIRE(objects.get(instance_3->my_hook()) == instance_3.get());
+    REQUIRE(instance_3->my_hook() != handle_3);
+}
+
+TEST_CASE("Tracker with small vector", "[single-file]")
+{
+    run_test<mock_tracker_with_small_vector>();
+    run_bulk_test<mock_tracker_with_small_vector>();
+    run_owned_test<mock_tracker_with_small_vector>();
+    run_deferred_test<mock_tracker_with_small_vector>();
+    run_chunk_test<mock_tracker_with_small_vector>();
+    run_parallel_test<mock_tracker_with_small_vector>();
+}
+
+TEST_CASE("Small vector stores few values inline", "[single-file]")
+{
+    using vector_type = wade::small_vector<int *, 4>;
+    std::vector<int> values(10);
+
+    // Values up to the inline capacity should not allocate.
+    vector_type a_vector{};
+    REQUIRE(a_vector.is_inline());
+    for (std::size_t i = 0; i != vector_type::inline_capacity; ++i)
+    {
+        a_vector.push_back(&values[i]);
+    }
+    REQUIRE(a_vector.is_inline());
+    REQUIRE(a_vector.capacity() == vector_type::inline_capacity);
+
+    // Moving an inline vector should copy its values and leave it empty.
+    vector_type moved{std::move(a_vector)};
+    REQUIRE(moved.is_inline());
+    REQUIRE(moved.size() == vector_type::inline_capacity);
+    REQUIRE(a_vector.empty());
+    REQUIRE(std::equal(moved.begin(), moved.end(), std::begin({&values[0], &values[1], &values[2], &values[3]})));
+
+    // Growing past the inline capacity should allocate and keep values in order.
+    for (std::size_t i = vector_type::inline_capacity; i != values.size(); ++i)
+    {
+        moved.insert(moved.end(), &values[i]);
+    }
+    REQUIRE_FALSE(moved.is_inline());
+    REQUIRE(moved.size() == values.size());
+    for (std::size_t i = 0; i != values.size(); ++i)
+    {
+        REQUIRE(moved[i] == &values[i]);
+    }
+
+    // Inserting and erasing in the middle should shift the following values.
+    REQUIRE(*moved.erase(moved.begin() + 2) == &values[3]);
+    REQUIRE(*moved.insert(moved.begin() + 2, &values[2]) == &values[2]);
+    auto && last = moved.erase(moved.begin() + 8, moved.end());
+    REQUIRE(last == moved.end());
+    REQUIRE(moved.size() == 8);
+    REQUIRE(moved[7] == &values[7]);
+
+    // Moving an allocated vector should take its storage, and copying should copy its values.
+    auto const data = moved.data();
+    a_vector = std::move(moved);
+    REQUIRE(a_vector.data() == data);
+    REQUIRE(moved.empty());
+    REQUIRE(moved.is_inline());
+    vector_type copied{a_vector};
+    REQUIRE(std::equal(a_vector.begin(), a_vector.end(), copied.begin(), copied.end()));
+    REQUIRE(copied.data() != data);
+
+    // Clearing should keep the storage for reuse.
+    a_vector.clear();
+    REQUIRE(a_vector.empty());
+    REQUIRE(a_vector.data() == data);
+}
+
+TEST_CASE("Tracker with small vector attaches few objects without allocating", "[single-file]")
+{
+    // Making a tracker and attaching up to the inline capacity should not allocate, and neither should detaching.
+    std::size_t const inline_capacity = mock_tracker_with_small_vector::container_type::inline_capacity;
+    std::vector<mock_tracker_with_small_vector::trackable> objects(inline_capacity + 1);
+    std::size_t const allocations = allocation_count;
+    {
+        mock_tracker_with_small_vector tracker{};
+        for (std::size_t i = 0; i != inline_capacity; ++i)
+        {
+            tracker.attach(&objects[i]);
+        }
+        REQUIRE(tracker.tracked_objects().is_inline());
+        REQUIRE(tracker.did_attach_count == inline_capacity);
+        objects.front().detach();
+        tracker.attach(&objects.front());
+        REQUIRE(allocation_count == allocations);
+
+        // Attaching one more should allocate once.
+        tracker.attach(&objects.back());
+        REQUIRE_FALSE(tracker.tracked_objects().is_inline());
+        REQUIRE(allocation_count == allocations + 1);
+        tracker.detach_all();
+    }
+    REQUIRE(allocation_count == allocations + 1);
+}
+
+TEST_CASE("Tracker with intrusive list", "[single-file]")
+{
+    run_test<mock_tracker_with_intrusive_list>();
+    run_bulk_test<mock_tracker_with_intrusive_list>();
+    run_owned_test<mock_tracker_with_intrusive_list>();
+}
+
+TEST_CASE("Intrusive list keeps objects in order when detaching", "[single-file]")
+{
+    mock_tracker_with_intrusive_list tracker{};
+    std::vector<mock_tracker_with_intrusive_list::trackable_ptr> owner{};
+    std::size_t const size = 10;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner.push_back(tracker.make());
+        owner.back()->value = static_cast<std::int64_t>(i);
+    }
+
+    // Detach from the front, middle, and back, which each relink different neighbors.
+    owner[0]->detach();
+    owner[5]->detach();
+    owner[9].reset();
+    REQUIRE(tracker.tracked_objects().size() == size - 3);
+    REQUIRE(tracker.did_detach_count == 3);
+    REQUIRE_FALSE(owner[0]->is_attached());
+    REQUIRE(owner[0]->my_hook().prev == nullptr);
+    REQUIRE(owner[0]->my_hook().next == nullptr);
+
+    // Remaining objects should be visited in order of attaching.
+    std::vector<std::int64_t> values{};
+    tracker.for_each([&](test_type & a_tracked) { values.push_back(a_tracked.value); });
+    REQUIRE(values == (std::vector<std::int64_t>{1, 2, 3, 4, 6, 7, 8}));
+
+    // Reattaching should link at the end.
+    tracker.attach(owner[0]);
+    values.clear();
+    tracker.for_each([&](test_type & a_tracked) { values.push_back(a_tracked.value); });
+    REQUIRE(values == (std::vector<std::int64_t>{1, 2, 3, 4, 6, 7, 8, 0}));
+
+    // Detaching the rest should leave nothing behind.
+    owner.clear();
+    REQUIRE(tracker.tracked_objects().empty());
+    REQUIRE(tracker.tracked_objects().begin() == tracker.tracked_objects().end());
+    REQUIRE(tracker.did_detach_count == size + 1);
+}
+
+TEST_CASE("Tracker with intrusive list attaches objects without allocating", "[single-file]")
+{
+    // Making a tracker, attaching, detaching, and moving it should never allocate, since objects are linked through their hooks.
+    std::vector<mock_tracker_with_intrusive_list::trackable> objects(100);
+    std::size_t const allocations = allocation_count;
+    {
+        mock_tracker_with_intrusive_list tracker{};
+        for (auto && instance : objects)
+        {
+            tracker.attach(&instance);
+        }
+        objects[50].detach();
+        tracker.attach(&objects[50]);
+        mock_tracker_with_intrusive_list tracker_2{std::move(tracker)};
+        REQUIRE(tracker_2.tracked_objects().size() == objects.size());
+        REQUIRE(objects.front().my_tracker() == &tracker_2);
+        tracker_2.detach_all();
+    }
+    REQUIRE(allocation_count == allocations);
+}
+
+TEST_CASE("Tracker with pool allocator", "[single-file]")
+{
+    run_test<mock_tracker_with_pool>();
+    run_bulk_test<mock_tracker_with_pool>();
+    run_owned_test<mock_tracker_with_pool>();
+    run_deferred_test<mock_tracker_with_pool>();
+    run_chunk_test<mock_tracker_with_pool>();
+    run_parallel_test<mock_tracker_with_pool>();
+}
+
+TEST_CASE("Pool allocator reuses memory and outlives its tracker", "[single-file]")
+{
+    // Destroying all owned instances should return all of their memory to the pool.
+    {
+        mock_tracker_with_pool tracker{};
+        for (int i = 0; i != 100; ++i)
+        {
+            tracker.make_owned();
+        }
+        REQUIRE(tracker.get_allocator().pool().size() == 100);
+        tracker.destroy_all();
+        REQUIRE(tracker.get_allocator().pool().size() == 0);
+    }
+
+    auto && tracker = std::make_unique<mock_tracker_with_pool>();
+    auto && pool = tracker->get_allocator().pool();
+
+    // Objects made in sequence should be adjacent in the same slab.
+    auto && instance_1 = tracker->make();
+    auto && instance_2 = tracker->make();
+    REQUIRE(pool.size() == 2);
+    REQUIRE(pool.capacity() == pool.slab_size());
+    REQUIRE(pool.block_size() >= sizeof(mock_tracker_with_pool::trackable));
+    REQUIRE(reinterpret_cast<char *>(instance_2.get()) - reinterpret_cast<char *>(instance_1.get()) == static_cast<std::ptrdiff_t>(pool.block_size()));
+
+    // Deleting an object should return its memory for the next object.
+    auto * const address_1 = instance_1.get();
+    instance_1.reset();
+    REQUIRE(pool.size() == 1);
+    REQUIRE(tracker->did_detach_count == 1);
+    instance_1 = tracker->make();
+    REQUIRE(instance_1.get() == address_1);
+    REQUIRE(pool.size() == 2);
+
+    // Filling a slab should allocate another.
+    std::vector<mock_tracker_with_pool::trackable_ptr> owner{};
+    while (pool.size() <= pool.slab_size())
+    {
+        owner.push_back(tracker->make());
+    }
+    REQUIRE(pool.capacity() == 2 * pool.slab_size());
+
+    // Objects should still be valid in the pool after their tracker is deleted.
+    tracker.reset();
+    REQUIRE(instance_2->is_detached());
+    instance_2->value = 2;
+    REQUIRE(instance_2->value == 2);
+    owner.clear();
+    instance_1.reset();
+    instance_2.reset();
+}
+
+TEST_CASE("Tracker without methods", "[single-file]")
+{
+    // All operations should work without any methods to call.
+    mock_tracker_without_methods tracker{};
+    auto && instance = tracker.make();
+    auto && owner = tracker.make_n(5);
+    REQUIRE(tracker.tracked_objects().size() == 6);
+    REQUIRE(instance->detach());
+    REQUIRE(tracker.attach(instance));
+    REQUIRE(tracker.detach(std::begin(owner), std::begin(owner) + 2) == 2);
+    tracker.detach_all();
+    REQUIRE(tracker.tracked_objects().empty());
+    REQUIRE(instance->is_detached());
+    REQUIRE(std::none_of(std::begin(owner), std::end(owner), [](mock_tracker_without_methods::trackable_ptr const & a_trackable) { return a_trackable->is_attached(); }));
+
+    // Only the defined method should be called.
+    mock_tracker_with_did_detach tracker_2{};
+    auto && owner_2 = tracker_2.make_n(5);
+    owner_2.front()->detach();
+    REQUIRE(tracker_2.did_detach_count == 1);
+    tracker_2.detach_all();
+    REQUIRE(tracker_2.did_detach_count == 5);
+    REQUIRE(owner_2.back()->is_detached());
+
+    // Likewise for a concurrent tracker.
+    mock_concurrent_tracker_without_methods tracker_3{};
+    auto && instance_3 = tracker_3.make();
+    REQUIRE(instance_3->detach());
+    REQUIRE(tracker_3.attach(instance_3.get()));
+    tracker_3.detach_all();
+    REQUIRE(instance_3->is_detached());
+}
+
+TEST_CASE("Moving a tracker keeps its objects attached to the moved tracker", "[single-file]")
+{
+    mock_tracker tracker{};
+    auto && owner = tracker.make_n(10);
+
+    // Moving should retarget all objects, and the moved-from tracker should still be able to attach others.
+    mock_tracker tracker_2{std::move(tracker)};
+    for (auto && instance : owner)
+    {
+        REQUIRE(instance->my_tracker() == &tracker_2);
+        REQUIRE(tracker_2.is_attached(instance));
+        REQUIRE(not tracker.is_attached(instance));
+    }
+    auto && other = tracker.make();
+    REQUIRE(other->my_tracker() == &tracker);
+    REQUIRE(not tracker_2.is_attached(other));
+
+    // Move assigning should detach old objects and retarget new ones, leaving both trackers usable.
+    tracker = std::move(tracker_2);
+    REQUIRE(other->is_detached());
+    REQUIRE(owner.front()->my_tracker() == &tracker);
+    REQUIRE(tracker.tracked_objects().size() == owner.size());
+    auto && another = tracker_2.make();
+    REQUIRE(another->my_tracker() == &tracker_2);
+    REQUIRE(tracker_2.tracked_objects().size() == 1);
+    another.reset();
+    REQUIRE(tracker_2.tracked_objects().empty());
+    owner.front()->detach();
+    REQUIRE(tracker.tracked_objects().size() == owner.size() - 1);
+}
+
+TEST_CASE("Default tracker pays only for features in use", "[single-file]")
+{
+    // A default tracker should store only its container, link, extension, and deferral counts (besides the counts of the mock).
+    REQUIRE(sizeof(mock_tracker) <= sizeof(std::vector<test_type *>) + 2 * sizeof(void *) + 2 * sizeof(std::uint32_t) + 3 * sizeof(std::size_t));
+    REQUIRE(sizeof(mock_tracker) < sizeof(mock_dirty_tracker));
+
+    // Attaching and detaching after reserving should not allocate (i.e., no control block or extension).
+    std::vector<mock_tracker::trackable> objects(10);
+    mock_tracker tracker{};
+    tracker.reserve(objects.size());
+    std::size_t const allocations = allocation_count;
+    for (auto && instance : objects)
+    {
+        tracker.attach(&instance);
+    }
+    REQUIRE(tracker.tracked_objects().size() == objects.size());
+    REQUIRE(tracker.snapshot() == nullptr);
+    REQUIRE(tracker.owned_size() == 0);
+    tracker.detach_all();
+    REQUIRE(allocation_count == allocations);
+}
+
+TEST_CASE("Tracker with stable links", "[single-file]")
+{
+    run_test<mock_stable_tracker>();
+    run_bulk_test<mock_stable_tracker>();
+    run_owned_test<mock_stable_tracker>();
+    run_deferred_test<mock_stable_tracker>();
+    run_chunk_test<mock_stable_tracker>();
+    run_parallel_test<mock_stable_tracker>();
+}
+
+TEST_CASE("Stable links survive moving their tracker", "[single-file]")
+{
+    mock_stable_tracker tracker{};
+    auto && owner = tracker.make_n(10);
+    mock_stable_tracker tracker_2{};
+    auto && other = tracker_2.make();
+
+    // Moving should keep each object's link, which finds the moved tracker.
+    mock_stable_tracker tracker_3{std::move(tracker)};
+    for (auto && instance : owner)
+    {
+        REQUIRE(instance->my_tracker() == &tracker_3);
+        REQUIRE(tracker_3.is_attached(instance));
+        REQUIRE(not tracker.is_attached(instance));
+    }
+
+    // The moved-from tracker should attach with a new link.
+    auto && another = tracker.make();
+    REQUIRE(another->my_tracker() == &tracker);
+    REQUIRE(not tracker_3.is_attached(another));
+
+    // Move assigning should detach old objects, and give its link to the moved-from tracker.
+    tracker_2 = std::move(tracker_3);
+    REQUIRE(other->is_detached());
+    REQUIRE(owner.front()->my_tracker() == &tracker_2);
+    REQUIRE(tracker_2.tracked_objects().size() == owner.size());
+    auto && last = tracker_3.make();
+    REQUIRE(last->my_tracker() == &tracker_3);
+    REQUIRE(not tracker_2.is_attached(last));
+    owner.front()->detach();
+    REQUIRE(tracker_2.tracked_objects().size() == owner.size() - 1);
+}
+
+TEST_CASE("Tracker with compact links", "[single-file]")
+{
+    run_test<mock_compact_tracker>();
+    run_bulk_test<mock_compact_tracker>();
+    run_owned_test<mock_compact_tracker>();
+    run_deferred_test<mock_compact_tracker>();
+    run_chunk_test<mock_compact_tracker>();
+    run_parallel_test<mock_compact_tracker>();
+}
+
+TEST_CASE("Compact links shrink objects and survive moving their tracker", "[single-file]")
+{
+    // Objects should store a 32-bit link and dirty index instead of a pointer and padding.
+    REQUIRE(sizeof(mock_compact_tracker::trackable) == sizeof(test_type) + 2 * sizeof(std::uint32_t));
+    REQUIRE(sizeof(mock_compact_tracker::trackable) < sizeof(mock_dirty_tracker::trackable));
+
+    // Objects of different trackers should have different links, which find their own trackers.
+    mock_compact_tracker tracker{};
+    mock_compact_tracker tracker_2{};
+    auto && owner = tracker.make_n(10);
+    auto && other = tracker_2.make();
+    REQUIRE(other->my_tracker() == &tracker_2);
+    REQUIRE(not tracker.is_attached(other));
+    for (auto && instance : owner)
+    {
+        REQUIRE(instance->my_tracker() == &tracker);
+    }
+
+    // Moving should keep the link, and copying should attach to the same tracker.
+    mock_compact_tracker tracker_3{std::move(tracker)};
+    REQUIRE(owner.front()->my_tracker() == &tracker_3);
+    REQUIRE(tracker_3.is_attached(owner.front()));
+    mock_compact_tracker::trackable copy{*owner.front()};
+    REQUIRE(copy.my_tracker() == &tracker_3);
+    REQUIRE(copy.mark_dirty());
+    REQUIRE(tracker_3.consume_dirty([](test_type &) {}) == 1);
+
+    // Ids of destroyed trackers should be reused without linking to them.
+    auto const id = wade::compact_link::acquire(nullptr);
+    wade::compact_link::release(id);
+    REQUIRE(id);
+    REQUIRE(wade::compact_link::acquire(&tracker) == id);
+    REQUIRE(id.get() == &tracker);
+    wade::compact_link::release(id);
+    REQUIRE(id.get() == nullptr);
+    REQUIRE_FALSE(wade::compact_link{});
+    REQUIRE(wade::compact_link{}.get() == nullptr);
+    (void)copy.detach();
+}
+
+TEST_CASE("Fixed tracker", "[single-file]")
+{
+    run_test<mock_fixed_tracker>();
+    run_bulk_test<mock_fixed_tracker>();
+    run_owned_test<mock_fixed_tracker>();
+    run_deferred_test<mock_fixed_tracker>();
+    run_chunk_test<mock_fixed_tracker>();
+    run_parallel_test<mock_fixed_tracker>();
+
+    // Moving should take the objects and the pool, leaving the source empty and unable to make objects.
+    mock_small_fixed_tracker tracker{};
+    auto && owner = tracker.make_n(2);
+    mock_small_fixed_tracker tracker_2{std::move(tracker)};
+    REQUIRE(tracker.tracked_objects().empty());
+    REQUIRE(tracker_2.tracked_objects().size() == 2);
+    REQUIRE(not tracker.get_allocator().has_pool());
+    REQUIRE(tracker_2.get_allocator().pool().size() == 2);
+    REQUIRE(tracker.make() == nullptr);
+    for (auto && instance : owner)
+    {
+        REQUIRE(instance->my_tracker() == &tracker_2);
+    }
+
+    // Destroying the source should not detach the moved objects.
+    {
+        mock_small_fixed_tracker tracker_3{std::move(tracker_2)};
+        {
+            mock_small_fixed_tracker moved_from{std::move(tracker_3)};
+            tracker_3 = std::move(moved_from);
+        }
+        REQUIRE(tracker_3.tracked_objects().size() == 2);
+        REQUIRE(tracker_3.did_detach_count == 0);
+        for (auto && instance : owner)
+        {
+            REQUIRE(instance->my_tracker() == &tracker_3);
+        }
+
+        // Move assigning should detach the old objects and take the new ones with their pool.
+        mock_small_fixed_tracker tracker_4{};
+        auto && other = tracker_4.make();
+        tracker_4 = std::move(tracker_3);
+        REQUIRE(other->is_detached());
+        REQUIRE(tracker_3.tracked_objects().empty());
+        REQUIRE(tracker_4.tracked_objects().size() == 2);
+        REQUIRE(tracker_4.get_allocator().pool().size() == 2);
+        REQUIRE(tracker_4.make());
+        owner.clear();
+        REQUIRE(tracker_4.tracked_objects().empty());
+        REQUIRE(tracker_2.tracked_objects().empty());
+    }
+}
+
+TEST_CASE("Fixed tracker reports when it is full", "[single-file]")
+{
+    mock_small_fixed_tracker tracker{};
+    REQUIRE(mock_small_fixed_tracker::capacity == 4);
+    REQUIRE(tracker.get_allocator().pool().capacity() == 4);
+    REQUIRE(not tracker.is_full());
+
+    // Making past the capacity should fail without notifying.
+    std::vector<mock_small_fixed_tracker::trackable_ptr> owner{};
+    for (std::size_t i = 0; i != 4; ++i)
+    {
+        owner.push_back(tracker.make());
+        REQUIRE(owner.back());
+    }
+    REQUIRE(tracker.is_full());
+    REQUIRE(tracker.make() == nullptr);
+    REQUIRE(tracker.did_make_count == 4);
+
+    // Objects made elsewhere should not attach to a full container, and copies should stay detached.
+    mock_small_fixed_tracker::trackable other{};
+    REQUIRE(not tracker.attach(&other));
+    REQUIRE(tracker.did_attach_count == 0);
+    mock_small_fixed_tracker::trackable copy{*owner.front()};
+    REQUIRE(copy.is_detached());
+
+    // A detached object should make room to attach, but not to make while its slot is still allocated.
+    REQUIRE(owner.back()->detach());
+    REQUIRE(tracker.is_full());
+    REQUIRE(tracker.make() == nullptr);
+    REQUIRE(tracker.attach(&other));
+    REQUIRE(other.detach());
+    owner.pop_back();
+    REQUIRE(not tracker.is_full());
+
+    // Batches should stop once full.
+    auto && batch = tracker.make_n(10);
+    REQUIRE(batch.size() == 1);
+    REQUIRE(tracker.tracked_objects().size() == 4);
+
+    // Migrating into a full tracker should leave the rest in the source.
+    batch.clear();
+    mock_small_fixed_tracker source{};
+    auto && source_owner = source.make_n(3);
+    REQUIRE(tracker.migrate_from(source, [](test_type const &) { return true; }) == 1);
+    REQUIRE(source.tracked_objects().size() == 2);
+    REQUIRE(tracker.is_full());
+    for (auto && instance : source_owner)
+    {
+        REQUIRE(instance->is_attached());
+    }
+
+    // The pool should never grow past its single slab, and reporting that it is full should not allocate, even when making owned objects.
+    std::size_t const did_make_count = tracker.did_make_count;
+    std::size_t const allocations = allocation_count;
+    bool const made = static_cast<bool>(tracker.make());
+    {
+        mock_small_fixed_tracker::trackable_ptr empty{};
+        (void)empty;
+    }
+    auto const owned = tracker.make_owned();
+    std::size_t const full_allocations = allocation_count - allocations;
+    REQUIRE(not made);
+    REQUIRE(owned == nullptr);
+    REQUIRE(tracker.owned_size() == 0);
+    REQUIRE(tracker.did_make_count == did_make_count);
+    REQUIRE(full_allocations == 0);
+    owner.clear();
+    source_owner.clear();
+    REQUIRE(tracker.tracked_objects().empty());
+    REQUIRE(tracker.get_allocator().pool().capacity() == 4);
+
+    // Making, attaching, marking, and detaching should never allocate, even though detaching dirty objects leaves them listed until compacted.
+    mock_small_fixed_tracker tracker_2{};
+    mock_small_fixed_tracker::trackable attached{};
+    std::size_t const cycle_start = allocation_count;
+    std::size_t max_dirty_size = 0;
+    for (std::size_t cycle = 0; cycle != 100; ++cycle)
+    {
+        auto && first = tracker_2.make();
+        auto && second = tracker_2.make();
+        (void)tracker_2.attach(&attached);
+        (void)first->mark_dirty();
+        (void)second->mark_dirty();
+        (void)attached.mark_dirty();
+        (void)second->detach();
+        first.reset();
+        (void)attached.detach();
+        max_dirty_size = std::max(max_dirty_size, tracker_2.dirty_size());
+    }
+    std::size_t const cycle_allocations = allocation_count - cycle_start;
+    REQUIRE(cycle_allocations == 0);
+    REQUIRE(max_dirty_size <= 2 * mock_small_fixed_tracker::capacity);
+    REQUIRE(tracker_2.tracked_objects().empty());
+    REQUIRE(tracker_2.consume_dirty([](test_type &) { FAIL(); }) == 0);
+}
+
+TEST_CASE("Tracker publishes snapshots for readers", "[single-file]")
+{
+    mock_tracker tracker{};
+    REQUIRE(tracker.snapshot() == nullptr);
+    auto && owner = tracker.make_n(10);
+
+    // Publishing copies the attached objects once, and publishing again without changes keeps the same snapshot.
+    tracker.publish();
+    auto && snapshot = tracker.snapshot();
+    REQUIRE(snapshot);
+    REQUIRE(snapshot->size() == owner.size());
+    tracker.publish();
+    REQUIRE(tracker.snapshot() == snapshot);
+
+    // Changes are only seen once published, and do not change older snapshots.
+    owner.pop_back();
+    REQUIRE(tracker.snapshot() == snapshot);
+    tracker.publish();
+    REQUIRE(tracker.snapshot() != snapshot);
+    REQUIRE(tracker.snapshot()->size() == owner.size());
+    REQUIRE(snapshot->size() == owner.size() + 1);
+
+    // Objects detached while deferring are not published.
+    {
+        auto && deferral = tracker.defer_detach();
+        owner.front()->detach();
+        tracker.publish();
+        REQUIRE(tracker.snapshot()->size() == owner.size() - 1);
+        REQUIRE(std::find(tracker.snapshot()->begin(), tracker.snapshot()->end(), nullptr) == tracker.snapshot()->end());
+        (void)deferral;
+    }
+
+    // Moving the tracker moves its snapshot.
+    auto && latest = tracker.snapshot();
+    mock_tracker tracker_2{std::move(tracker)};
+    REQUIRE(tracker_2.snapshot() == latest);
+    REQUIRE(tracker.snapshot() == nullptr);
+    tracker_2.detach_all();
+    tracker_2.publish();
+    REQUIRE(tracker_2.snapshot()->empty());
+
+    // Readers on another thread should only see whole batches while the tracker attaches and detaches.
+    // Note: count errors atomically since Catch2 is not thread-safe.
+    std::size_t const batch_size = 10;
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> errors{0};
+    std::thread reader{[&]
+    {
+        while (not done)
+        {
+            if (auto && a_snapshot = tracker_2.snapshot())
+            {
+                errors += a_snapshot->size() % batch_size != 0 ? 1 : 0;
+            }
+        }
+    }};
+    for (std::size_t i = 0; i != 1000; ++i)
+    {
+        auto && batch = tracker_2.make_n(batch_size);
+        tracker_2.publish();
+        if (i % 2 == 0)
+        {
+            owner.insert(std::end(owner), std::make_move_iterator(std::begin(batch)), std::make_move_iterator(std::end(batch)));
+        }
+    }
+    done = true;
+    reader.join();
+    REQUIRE(errors == 0);
+}
+
+TEST_CASE("Tracker with stats", "[single-file]")
+{
+    run_test<mock_tracker_with_stats>();
+    run_bulk_test<mock_tracker_with_stats>();
+    run_deferred_test<mock_tracker_with_stats>();
+
+    // Each operation should be counted once and in one histogram bucket.
+    mock_tracker_with_stats tracker{};
+    std::vector<mock_tracker_with_stats::trackable_ptr> owner{};
+    std::size_t const size = 10;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner.push_back(tracker.make());
+    }
+    owner[3].reset();
+    owner[4]->detach();
+    tracker.attach(owner[4]);
+
+    auto && stats = tracker.stats();
+    REQUIRE(stats[wade::tracker_operation::make].count == size);
+    REQUIRE(stats[wade::tracker_operation::connect].count == size + 1);
+    REQUIRE(stats[wade::tracker_operation::disconnect].count == 2);
+    REQUIRE(stats[wade::tracker_operation::dispatch].count == size + 3);
+    REQUIRE(stats.max_size == size);
+    for (auto && operation : stats.operations)
+    {
+        std::uint64_t bucket_sum = 0;
+        for (auto && a_count : operation.histogram)
+        {
+            bucket_sum += a_count;
+        }
+        REQUIRE(bucket_sum == operation.count);
+    }
+
+    // Operations on other threads should be recorded too.
+    std::thread a_thread{[&tracker]() { auto && an_object = tracker.make(); an_object->detach(); }};
+    a_thread.join();
+    REQUIRE(tracker.stats()[wade::tracker_operation::make].count == size + 1);
+    REQUIRE(tracker.stats()[wade::tracker_operation::disconnect].count == 3);
+}
+
+TEST_CASE("Tracker consumes dirty objects once", "[single-file]")
+{
+    // Objects should only store their place in the dirty list with a dirty policy.
+    REQUIRE(sizeof(mock_tracker::trackable) == sizeof(test_type) + sizeof(void *));
+    REQUIRE(sizeof(mock_dirty_tracker::trackable) > sizeof(mock_tracker::trackable));
+    REQUIRE(not mock_tracker::trackable{}.is_dirty());
+
+    mock_dirty_tracker tracker{};
+    std::vector<mock_dirty_tracker::trackable_ptr> owner{};
+    std::size_t const size = 10;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner.push_back(tracker.make(static_cast<std::int64_t>(i)));
+    }
+
+    // Marking twice should only list an object once, and detached objects cannot be marked.
+    REQUIRE(owner[2]->mark_dirty());
+    REQUIRE(not owner[2]->mark_dirty());
+    REQUIRE(owner[5]->mark_dirty());
+    REQUIRE(owner[7]->mark_dirty());
+    REQUIRE(owner[2]->is_dirty());
+    REQUIRE(not owner[3]->is_dirty());
+    mock_dirty_tracker::trackable detached{};
+    REQUIRE(not detached.mark_dirty());
+    REQUIRE(tracker.dirty_size() == 3);
+
+    // Detaching should remove an object from the list, and moving should keep it dirty.
+    owner[5].reset();
+    mock_dirty_tracker::trackable moved{std::move(*owner[7])};
+    REQUIRE(not owner[7]->is_dirty());
+    REQUIRE(moved.is_dirty());
+
+    // Consuming should visit each dirty object in order of marking, and objects marked during consuming should wait for the next call.
+    std::vector<test_type *> consumed{};
+    REQUIRE(tracker.consume_dirty([&](test_type & a_tracked)
+    {
+        consumed.push_back(&a_tracked);
+        REQUIRE(not static_cast<mock_dirty_tracker::trackable &>(a_tracked).is_dirty());
+        owner[9]->mark_dirty();
+    }) == 2);
+    REQUIRE(consumed == (std::vector<test_type *>{owner[2].get(), &moved}));
+    REQUIRE(not owner[2]->is_dirty());
+    REQUIRE(tracker.dirty_size() == 1);
+    consumed.clear();
+    REQUIRE(tracker.consume_dirty([&](test_type & a_tracked) { consumed.push_back(&a_tracked); }) == 1);
+    REQUIRE(consumed == (std::vector<test_type *>{owner[9].get()}));
+    REQUIRE(tracker.consume_dirty([&](test_type &) { FAIL(); }) == 0);
+
+    // Moving the tracker should move the list, and detaching all should clear it.
+    REQUIRE(owner[1]->mark_dirty());
+    mock_dirty_tracker tracker_2{std::move(tracker)};
+    REQUIRE(tracker.dirty_size() == 0);
+    REQUIRE(tracker_2.dirty_size() == 1);
+    REQUIRE(owner[1]->is_dirty());
+    tracker_2.detach_all();
+    REQUIRE(not owner[1]->is_dirty());
+    REQUIRE(tracker_2.dirty_size() == 0);
+}
+
+TEST_CASE("Tracker with batches", "[single-file]")
+{
+    mock_tracker_with_batches tracker{};
+    auto && owner = tracker.make_n(5);
+    REQUIRE(tracker.tracked_objects().size() == 5);
+    REQUIRE(tracker.did_make_batch_sizes == std::vector<std::size_t>{5});
+
+    // Batches should only include instances that changed, and per-object methods should not be called.
+    REQUIRE(tracker.detach(std::begin(owner), std::begin(owner) + 2) == 2);
+    REQUIRE(tracker.attach(std::begin(owner), std::end(owner)) == 2);
+    REQUIRE(tracker.detach(std::begin(owner), std::end(owner)) == 5);
+    REQUIRE(tracker.did_attach_batch_sizes == std::vector<std::size_t>{2});
+    REQUIRE(tracker.did_detach_batch_sizes == (std::vector<std::size_t>{2, 5}));
+    REQUIRE(tracker.did_make_count == 0);
+    REQUIRE(tracker.did_attach_count == 0);
+    REQUIRE(tracker.did_detach_count == 0);
+
+    // Empty batches should not notify.
+    REQUIRE(tracker.detach(std::begin(owner), std::end(owner)) == 0);
+    REQUIRE(tracker.make_n(0).empty());
+    REQUIRE(tracker.did_make_batch_sizes.size() == 1);
+    REQUIRE(tracker.did_detach_batch_sizes.size() == 2);
+
+    // Single-object methods should still use per-object notifications.
+    tracker.attach(owner.front());
+    owner.front()->detach();
+    REQUIRE(tracker.did_attach_count == 1);
+    REQUIRE(tracker.did_detach_count == 1);
+}
+
+TEST_CASE("Tracker migrates objects from another tracker in bulk", "[single-file]")
+{
+    mock_tracker_with_batches source{};
+    mock_tracker_with_batches destination{};
+    auto && owner = source.make_n(10);
+    for (std::size_t i = 0; i != owner.size(); ++i)
+    {
+        owner[i]->value = static_cast<std::int64_t>(i);
+    }
+    auto && is_even = [](test_type const & a_tracked) { return a_tracked.value % 2 == 0; };
+
+    // Matching objects should move in order with one batch for each tracker.
+    REQUIRE(destination.migrate_from(source, is_even) == 5);
+    REQUIRE(source.tracked_objects().size() == 5);
+    REQUIRE(destination.tracked_objects().size() == 5);
+    REQUIRE(source.did_detach_batch_sizes == std::vector<std::size_t>{5});
+    REQUIRE(destination.did_attach_batch_sizes == std::vector<std::size_t>{5});
+    for (std::size_t i = 0; i != owner.size(); ++i)
+    {
+        REQUIRE(owner[i]->my_tracker() == (i % 2 == 0 ? &destination : &source));
+    }
+    for (std::size_t i = 0; i != destination.tracked_objects().size(); ++i)
+    {
+        REQUIRE(destination.tracked_objects()[i]->value == static_cast<std::int64_t>(i * 2));
+    }
+
+    // Migrating nothing should not notify.
+    REQUIRE(destination.migrate_from(source, is_even) == 0);
+    REQUIRE(source.did_detach_batch_sizes.size() == 1);
+    REQUIRE(destination.did_attach_batch_sizes.size() == 1);
+
+    // Containers with hooks should update the hooks of objects left in the source.
+    mock_tracker_with_unordered_vector source_2{};
+    mock_tracker_with_unordered_vector destination_2{};
+    auto && owner_2 = source_2.make_n(10);
+    for (std::size_t i = 0; i != owner_2.size(); ++i)
+    {
+        owner_2[i]->value = static_cast<std::int64_t>(i);
+    }
+    REQUIRE(destination_2.migrate_from(source_2, is_even) == 5);
+    REQUIRE(source_2.did_detach_count == 5);
+    REQUIRE(destination_2.did_attach_count == 5);
+    for (std::size_t i = 0; i != source_2.tracked_objects().size(); ++i)
+    {
+        REQUIRE(static_cast<mock_tracker_with_unordered_vector::trackable *>(source_2.tracked_objects()[i])->my_hook() == i);
+    }
+    owner_2.clear();
+    REQUIRE(source_2.tracked_objects().empty());
+    REQUIRE(destination_2.tracked_objects().empty());
+}
+
+TEST_CASE("Tracker saves and loads objects in bulk", "[single-file]")
+{
+    mock_tracker_with_batches tracker{};
+    auto && owner = tracker.make_n(100);
+    for (std::size_t i = 0; i != owner.size(); ++i)
+    {
+        owner[i]->value = static_cast<std::int64_t>(i * i);
+    }
+    {
+        // Objects detached while deferring should not be saved.
+        auto && deferral = tracker.defer_detach();
+        owner[7]->detach();
+        std::ostringstream stream{std::ios::binary};
+        wade::save(tracker, stream);
+        (void)deferral;
+
+        // Loading from memory should make each saved object with a single notification.
+        std::string const archive = stream.str();
+        REQUIRE(archive.size() == sizeof(wade::archive_header) + (owner.size() - 1) * sizeof(test_type));
+        mock_tracker_with_batches tracker_2{};
+        auto && loaded = wade::load(tracker_2, wade::span<char const>{archive.data(), archive.size()});
+        REQUIRE(loaded.size() == owner.size() - 1);
+        REQUIRE(tracker_2.tracked_objects().size() == loaded.size());
+        REQUIRE(tracker_2.did_make_batch_sizes == std::vector<std::size_t>{loaded.size()});
+        REQUIRE(tracker_2.did_make_count == 0);
+        std::int64_t sum = 0;
+        std::int64_t expected_sum = 0;
+        for (std::size_t i = 0; i != loaded.size(); ++i)
+        {
+            REQUIRE(tracker_2.is_attached(loaded[i]));
+            sum += loaded[i]->value;
+            expected_sum += owner[i < 7 ? i : i + 1]->value;
+        }
+        REQUIRE(sum == expected_sum);
+
+        // Loading from a stream should make the same objects.
+        std::istringstream in{archive, std::ios::binary};
+        mock_tracker tracker_3{};
+        auto && loaded_3 = wade::load(tracker_3, in);
+        REQUIRE(loaded_3.size() == loaded.size());
+        REQUIRE(tracker_3.did_make_count == loaded.size());
+        REQUIRE(loaded_3.back()->value == owner.back()->value);
+
+        // Archives that are truncated or of another type should be rejected without making any objects.
+        mock_tracker tracker_4{};
+        REQUIRE_THROWS_AS(wade::load(tracker_4, wade::span<char const>{archive.data(), archive.size() - 1}), std::runtime_error);
+        REQUIRE_THROWS_AS(wade::load(tracker_4, wade::span<char const>{archive.data(), 4}), std::runtime_error);
+        std::string corrupted = archive;
+        corrupted[0] = 'x';
+        REQUIRE_THROWS_AS(wade::load(tracker_4, wade::span<char const>{corrupted.data(), corrupted.size()}), std::runtime_error);
+        corrupted = archive;
+        corrupted[offsetof(wade::archive_header, object_size)] = 4;
+        REQUIRE_THROWS_AS(wade::load(tracker_4, wade::span<char const>{corrupted.data(), corrupted.size()}), std::runtime_error);
+        REQUIRE(tracker_4.tracked_objects().empty());
+    }
+}
+
+TEST_CASE("SoA tracker", "[single-file]")
+{
+    // Make instances with and without field values.
+    mock_soa_tracker tracker{};
+    std::vector<mock_soa_tracker::handle> owner{};
+    std::size_t const size = 10;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner.push_back(tracker.make(static_cast<std::int64_t>(i), 0.5));
+    }
+    owner.push_back(tracker.make());
+    REQUIRE(tracker.size() == size + 1);
+    REQUIRE(tracker.did_make_count == size + 1);
+    REQUIRE(owner.back().get<0>() == 0);
+    REQUIRE(owner.back().get<1>() == 0.0);
+
+    // Handles should refer to their own rows, even after moving in the vector.
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        REQUIRE(owner[i].is_attached());
+        REQUIRE(&tracker.owner(owner[i].my_index()) == &owner[i]);
+        REQUIRE(owner[i].get<0>() == static_cast<std::int64_t>(i));
+    }
+
+    // Update a field of all instances through its column.
+    auto && values = tracker.column<0>();
+    auto && weights = tracker.column<1>();
+    REQUIRE(values.size() == size + 1);
+    for (std::size_t i = 0; i != values.size(); ++i)
+    {
+        values[i] += static_cast<std::int64_t>(weights[i] * 2);
+    }
+    REQUIRE(owner[3].get<0>() == 4);
+    REQUIRE(owner.back().get<0>() == 0);
+
+    // Visit fields of all instances individually and in aligned chunks.
+    std::int64_t sum = 0;
+    tracker.for_each<0, 1>([&](std::int64_t & a_value, double const & a_weight) { sum += a_value + static_cast<std::int64_t>(a_weight); });
+    REQUIRE(sum == 55);
+    sum = 0;
+    tracker.for_each_chunk<1, 0>([&](wade::span<double> a_weights, wade::span<std::int64_t> a_values)
+    {
+        REQUIRE(a_weights.size() == a_values.size());
+        REQUIRE(reinterpret_cast<std::uintptr_t>(a_values.data()) % mock_soa_tracker::column_alignment == 0);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(a_weights.data()) % mock_soa_tracker::column_alignment == 0);
+        for (auto && a_value : a_values)
+        {
+            sum += a_value;
+        }
+    });
+    REQUIRE(sum == 55);
+
+    // Visit chunks in parallel.
+    wade::thread_pool pool{2};
+    std::atomic<std::int64_t> parallel_sum{0};
+    tracker.for_each_chunk<0>(pool, [&](wade::span<std::int64_t> a_values)
+    {
+        for (auto && a_value : a_values)
+        {
+            parallel_sum += a_value;
+        }
+    });
+    REQUIRE(parallel_sum == 55);
+
+    // Detaching should destroy fields and move the last row into the detached row.
+    REQUIRE(owner[0].detach());
+    REQUIRE(not owner[0].detach());
+    REQUIRE(owner[0].is_detached());
+    REQUIRE(tracker.size() == size);
+    REQUIRE(tracker.did_detach_count == 1);
+    REQUIRE(tracker.detached_sum == 1);
+    REQUIRE(owner.back().my_index() == 0);
+    REQUIRE(&tracker.owner(0) == &owner.back());
+
+    // Moving a handle should transfer its row, and deleting one should detach it.
+    mock_soa_tracker::handle moved{std::move(owner[5])};
+    REQUIRE(owner[5].is_detached());
+    REQUIRE(moved.get<0>() == 6);
+    REQUIRE(&tracker.owner(moved.my_index()) == &moved);
+    owner[5] = std::move(moved);
+    REQUIRE(owner[5].get<0>() == 6);
+    owner.pop_back();
+    REQUIRE(tracker.size() == size - 1);
+    REQUIRE(tracker.did_detach_count == 2);
+
+    // Moving the tracker should transfer all instances.
+    mock_soa_tracker tracker_2{std::move(tracker)};
+    REQUIRE(tracker.empty());
+    REQUIRE(tracker_2.size() == size - 1);
+    REQUIRE(owner[5].my_tracker() == &tracker_2);
+    REQUIRE(owner[5].get<0>() == 6);
+
+    // Detaching all should detach all handles.
+    // Note: counts were moved with the tracker.
+    tracker_2.detach_all();
+    REQUIRE(tracker_2.empty());
+    REQUIRE(tracker_2.did_detach_count == 2 + size - 1);
+    for (auto && a_handle : owner)
+    {
+        REQUIRE(a_handle.is_detached());
+    }
+
+    // All operations should work without any methods to call.
+    mock_soa_tracker_without_methods tracker_3{};
+    auto && instance = tracker_3.make(std::int64_t{7});
+    auto && other = tracker_3.make(std::int64_t{8});
+    REQUIRE(tracker_3.size() == 2);
+    REQUIRE(instance.detach());
+    REQUIRE(tracker_3.size() == 1);
+    REQUIRE(tracker_3.column<0>()[0] == 8);
+    tracker_3.detach_all();
+    REQUIRE(tracker_3.empty());
+    REQUIRE(other.is_detached());
+}
+
+TEST_CASE("Owning tracker", "[single-file]")
+{
+    // Make objects in place across several chunks.
+    mock_owning_tracker tracker{};
+    std::vector<std::int64_t *> owner{};
+    std::size_t const size = 200;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner.push_back(&tracker.make(static_cast<std::int64_t>(i)));
+    }
+    REQUIRE(tracker.size() == size);
+    REQUIRE(tracker.capacity() == 4 * mock_owning_tracker::chunk_size);
+    REQUIRE(tracker.did_make_count == size);
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        REQUIRE(*owner[i] == static_cast<std::int64_t>(i));
+        REQUIRE(tracker.is_attached(*owner[i]));
+    }
+    std::int64_t other = 0;
+    REQUIRE(not tracker.is_attached(other));
+
+    // Visit objects in memory order.
+    std::vector<std::int64_t *> visited{};
+    tracker.for_each([&](std::int64_t & a_value) { visited.push_back(&a_value); });
+    REQUIRE(visited.size() == size);
+    REQUIRE(std::is_sorted(std::begin(visited), std::end(visited), std::less<std::int64_t *>{}));
+
+    // Destroying should notify, and later objects should reuse the memory.
+    tracker.destroy(*owner[10]);
+    REQUIRE(tracker.size() == size - 1);
+    REQUIRE(tracker.did_detach_count == 1);
+    REQUIRE(tracker.detached_sum == 10);
+    REQUIRE(not tracker.is_attached(*owner[10]));
+    std::int64_t & reused = tracker.make(std::int64_t{-1});
+    REQUIRE(&reused == owner[10]);
+    REQUIRE(tracker.capacity() == 4 * mock_owning_tracker::chunk_size);
+
+    // Moving the tracker should keep objects in place.
+    mock_owning_tracker tracker_2{std::move(tracker)};
+    REQUIRE(tracker.empty());
+    REQUIRE(tracker.capacity() == 0);
+    REQUIRE(tracker_2.size() == size);
+    REQUIRE(tracker_2.is_attached(*owner[20]));
+    REQUIRE(*owner[20] == 20);
+
+    // Destroying all should notify each object once.
+    // Note: counts were moved with the tracker.
+    tracker_2.destroy_all();
+    REQUIRE(tracker_2.empty());
+    REQUIRE(tracker_2.did_detach_count == 1 + size);
+    REQUIRE(tracker_2.detached_sum == 10 + (size * (size - 1) / 2) - 10 - 1);
+
+    // Making objects while visiting should never visit an object twice, even if new chunks are allocated before the current one.
+    // Note: freeing another tracker's chunks first lets new chunks reuse their (likely lower) addresses.
+    mock_owning_tracker freed{};
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        freed.make(std::int64_t{0});
+    }
+    mock_owning_tracker tracker_3{};
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        tracker_3.make(static_cast<std::int64_t>(i));
+    }
+    freed.destroy_all();
+    std::vector<std::size_t> visits(size);
+    bool made = false;
+    tracker_3.for_each([&](std::int64_t & a_value)
+    {
+        if (a_value >= 0)
+        {
+            ++visits[static_cast<std::size_t>(a_value)];
+        }
+        if (not made)
+        {
+            made = true;
+            for (std::size_t i = 0; i != size; ++i)
+            {
+                tracker_3.make(std::int64_t{-1});
+            }
+        }
+    });
+    REQUIRE(tracker_3.size() == 2 * size);
+    REQUIRE(std::all_of(std::begin(visits), std::end(visits), [](std::size_t a_count) { return a_count == 1; }));
+}
+
+TEST_CASE("Thread pool runs every index once", "[single-file]")
+{
+    // Every index should run once, with or without worker threads.
+    for (std::size_t thread_count : {0, 1, 4})
+    {
+        wade::thread_pool pool{thread_count};
+        REQUIRE(pool.size() == thread_count);
+        std::vector<std::atomic<int> > counts(1000);
+        pool.parallel_for(counts.size(), [&](std::size_t a_index) { ++counts[a_index]; });
+        REQUIRE(std::all_of(std::begin(counts), std::end(counts), [](std::atomic<int> const & a_count) { return a_count == 1; }));
+        pool.parallel_for(0, [&](std::size_t) { ++counts[0]; });
+        REQUIRE(counts[0] == 1);
+
+        // The first exception should be rethrown after all calls are done.
+        REQUIRE_THROWS_AS(pool.parallel_for(counts.size(), [](std::size_t a_index)
+        {
+            if (a_index == 10)
+            {
+                throw std::runtime_error{"failed"};
+            }
+        }), std::runtime_error);
+    }
+
+    // Calls may use another pool (but never their own, which would deadlock).
+    wade::thread_pool outer{2};
+    wade::thread_pool inner{2};
+    std::atomic<int> nested{0};
+    outer.parallel_for(4, [&](std::size_t) { inner.parallel_for(10, [&](std::size_t) { ++nested; }); });
+    REQUIRE(nested == 40);
+
+    // Submitted tasks should finish before the pool is destroyed.
+    std::atomic<int> finished{0};
+    {
+        wade::thread_pool pool{2};
+        for (int i = 0; i != 10; ++i)
+        {
+            pool.submit([&finished] { ++finished; });
+        }
+    }
+    REQUIRE(finished == 10);
+}
+
+TEST_CASE("Work-stealing pool runs all tasks", "[single-file]")
+{
+    // Tasks submitted from tasks should also run before the pool is destroyed.
+    std::atomic<int> finished{0};
+    {
+        wade::work_stealing_pool pool{3};
+        REQUIRE(pool.size() == 3);
+        for (int i = 0; i != 100; ++i)
+        {
+            pool.submit([&]
+            {
+                pool.submit([&finished] { ++finished; });
+                ++finished;
+            });
+        }
+    }
+    REQUIRE(finished == 200);
+}
+
+TEST_CASE("Async tracker calls methods in order for each object", "[single-file]")
+{
+    wade::work_stealing_pool pool{4};
+    mock_async_tracker tracker{pool};
+    std::size_t const size = 200;
+    auto && owner = tracker.make_n(size);
+
+    // Reattach half of the instances, which should wait for their queued make.
+    for (std::size_t i = 0; i != size / 2; ++i)
+    {
+        owner[i]->detach();
+        tracker.attach(owner[i]);
+    }
+    tracker.flush();
+    REQUIRE(tracker.did_make_count == size);
+    REQUIRE(tracker.did_attach_count == size / 2);
+    REQUIRE(tracker.did_detach_count == size / 2);
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        REQUIRE(owner[i]->value == (i < size / 2 ? 132 : 1));
+    }
+
+    // Moving instances to another tracker should queue attach on that tracker.
+    mock_async_tracker tracker_2{pool};
+    REQUIRE(tracker_2.attach(std::begin(owner), std::begin(owner) + 10) == 10);
+    tracker_2.flush();
+    REQUIRE(tracker_2.did_attach_count == 10);
+    REQUIRE(owner[0]->value == 13232);
+
+    // Deleting instances detaches them directly.
+    owner.clear();
+    REQUIRE(tracker.did_detach_count == size / 2 + size);
+    REQUIRE(tracker_2.did_detach_count == 10);
+    REQUIRE(tracker.tracked_objects().empty());
+
+    // Methods that are not defined should not be needed or queued.
+    mock_partial_async_tracker tracker_3{pool};
+    auto && owner_3 = tracker_3.make_n(10);
+    mock_partial_async_tracker::trackable attached{};
+    REQUIRE(tracker_3.attach(&attached));
+    tracker_3.flush();
+    REQUIRE(tracker_3.did_attach_count == 1);
+    REQUIRE(attached.detach());
+    owner_3.clear();
+    REQUIRE(tracker_3.tracked_objects().empty());
+
+    // Batch methods of the derived class should be queued for batches, and detaching should call them directly.
+    mock_batch_async_tracker tracker_4{pool};
+    auto && owner_4 = tracker_4.make_n(100);
+    auto && instance_4 = tracker_4.make();
+    REQUIRE(tracker_4.detach(std::begin(owner_4), std::begin(owner_4) + 50) == 50);
+    REQUIRE(tracker_4.did_detach_count == 50);
+    REQUIRE(tracker_4.did_detach_batch_count == 1);
+    REQUIRE(tracker_4.attach(std::begin(owner_4), std::begin(owner_4) + 20) == 20);
+    tracker_4.flush();
+    REQUIRE(tracker_4.did_make_count == 100);
+    REQUIRE(tracker_4.did_attach_count == 20);
+    REQUIRE(instance_4->detach());
+    REQUIRE(tracker_4.did_detach_count == 50);
+    tracker_4.detach(std::begin(owner_4), std::end(owner_4));
+    REQUIRE(tracker_4.did_detach_count == 120);
+}
+
+TEST_CASE("MPSC ring keeps values in order", "[single-file]")
+{
+    // Fill the ring, which should then refuse values.
+    wade::mpsc_ring<int, 4> ring{};
+    REQUIRE(ring.empty());
+    for (int i = 0; i != 4; ++i)
+    {
+        REQUIRE(ring.try_push(i));
+    }
+    REQUIRE(not ring.try_push(4));
+
+    // Take values in order, wrapping around the ring.
+    int value = -1;
+    REQUIRE(ring.try_pop(value));
+    REQUIRE(value == 0);
+    REQUIRE(ring.try_push(4));
+    std::vector<int> values{};
+    REQUIRE(ring.drain([&](int a_value) { values.push_back(a_value); }, 3) == 3);
+    REQUIRE(values == (std::vector<int>{1, 2, 3}));
+    REQUIRE(ring.drain([&](int a_value) { values.push_back(a_value); }) == 1);
+    REQUIRE(values.back() == 4);
+    REQUIRE(ring.empty());
+    REQUIRE(not ring.try_pop(value));
+}
+
+TEST_CASE("MPSC ring takes values from many producers", "[single-file]")
+{
+    // Each producer pushes increasing values tagged with its index, which the consumer should see in order for each producer.
+    wade::mpsc_ring<std::int64_t, 64> ring{};
+    std::size_t const thread_count = 4;
+    std::int64_t const count = 20000;
+    std::vector<std::thread> producers{};
+    for (std::size_t t = 0; t != thread_count; ++t)
+    {
+        producers.emplace_back([&ring, t, count]
+        {
+            for (std::int64_t i = 0; i != count; ++i)
+            {
+                ring.push(i * static_cast<std::int64_t>(thread_count) + static_cast<std::int64_t>(t));
+            }
+        });
+    }
+
+    std::vector<std::int64_t> next(thread_count, 0);
+    std::size_t taken = 0;
+    std::size_t out_of_order = 0;
+    while (taken != thread_count * count)
+    {
+        taken += ring.drain([&](std::int64_t a_value)
+        {
+            auto const t = static_cast<std::size_t>(a_value % static_cast<std::int64_t>(thread_count));
+            out_of_order += (a_value / static_cast<std::int64_t>(thread_count) != next[t]++);
+        });
+    }
+    for (auto && a_producer : producers)
+    {
+        a_producer.join();
+    }
+    REQUIRE(out_of_order == 0);
+    REQUIRE(ring.empty());
+}
+
+TEST_CASE("Tracker publishes events", "[single-file]")
+{
+    // Events should be published in order of changes.
+    using event_kind = wade::tracker_event_kind;
+    std::vector<event_kind> kinds{};
+    std::vector<test_type *> objects{};
+    auto && consume = [&](mock_publishing_tracker::event_type an_event)
+    {
+        kinds.push_back(an_event.kind);
+        objects.push_back(an_event.object);
+    };
+    {
+        mock_publishing_tracker tracker{};
+        auto && instance = tracker.make();
+        instance->detach();
+        tracker.attach(instance);
+        REQUIRE(tracker.events().drain(consume) == 3);
+        REQUIRE(kinds == (std::vector<event_kind>{event_kind::make, event_kind::detach, event_kind::attach}));
+        REQUIRE(std::all_of(std::begin(objects), std::end(objects), [&](test_type * an_object) { return an_object == instance.get(); }));
+
+        // Detaching all should publish a detach for each instance.
+        auto && owner = tracker.make_n(10);
+        REQUIRE(tracker.events().drain(consume) == 10);
+        kinds.clear();
+        tracker.detach_all();
+        REQUIRE(tracker.events().drain(consume) == 11);
+        REQUIRE(kinds == std::vector<event_kind>(11, event_kind::detach));
+        REQUIRE(tracker.dropped_count() == 0);
+    }
+
+    // Publishing more events than fit without draining (i.e., on the consumer's thread) should drop and count them instead of waiting if asked to.
+    {
+        mock_dropping_tracker tracker{};
+        std::size_t const capacity = mock_dropping_tracker::ring_type::capacity();
+        auto && owner = tracker.make_n(capacity + 10);
+        REQUIRE(tracker.dropped_count() == 10);
+        kinds.clear();
+        REQUIRE(tracker.events().drain(consume) == capacity);
+        REQUIRE(kinds == std::vector<event_kind>(capacity, event_kind::make));
+
+        // Room should be reused once drained, and destroying many objects should not wait for a consumer.
+        tracker.detach_all();
+        REQUIRE(tracker.dropped_count() == 20);
+        REQUIRE(tracker.events().drain(consume) == capacity);
+        owner.clear();
+        REQUIRE(tracker.tracked_objects().empty());
+    }
+
+    // Events from many threads should all be published while a consumer drains them, even when they overflow the ring.
+    mock_publishing_concurrent_tracker tracker{};
+    std::size_t const thread_count = 4;
+    std::size_t const count = 2000;
+    std::atomic<bool> done{false};
+    std::size_t makes = 0;
+    std::size_t detaches = 0;
+    std::thread consumer{[&]
+    {
+        auto && count_event = [&](mock_publishing_concurrent_tracker::event_type an_event)
+        {
+            makes += an_event.kind == event_kind::make;
+            detaches += an_event.kind == event_kind::detach;
+        };
+        while (not done)
+        {
+            tracker.events().drain(count_event);
+        }
+        tracker.events().drain(count_event);
+    }};
+    std::vector<std::thread> producers{};
+    for (std::size_t t = 0; t != thread_count; ++t)
+    {
+        producers.emplace_back([&tracker, count]
+        {
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                tracker.make();
+            }
+        });
+    }
+    for (auto && a_producer : producers)
+    {
+        a_producer.join();
+    }
+    done = true;
+    consumer.join();
+    REQUIRE(makes == thread_count * count);
+    REQUIRE(detaches == thread_count * count);
+    REQUIRE(tracker.dropped_count() == 0);
+
+    // Likewise for a tracker on one thread that publishes more events at once than fit.
+    mock_publishing_tracker tracker_2{};
+    std::size_t const capacity = mock_publishing_tracker::ring_type::capacity();
+    std::atomic<bool> done_2{false};
+    std::size_t count_2 = 0;
+    std::thread consumer_2{[&]
+    {
+        auto && count_event = [&](mock_publishing_tracker::event_type) { ++count_2; };
+        while (not done_2)
+        {
+            tracker_2.events().drain(count_event);
+        }
+        tracker_2.events().drain(count_event);
+    }};
+    {
+        auto && owner = tracker_2.make_n(4 * capacity);
+        tracker_2.detach_all();
+    }
+    done_2 = true;
+    consumer_2.join();
+    REQUIRE(count_2 == 8 * capacity);
+    REQUIRE(tracker_2.dropped_count() == 0);
+}
+
+template <typename Tracker_T>
+void run_concurrent_test()
+{
+    // Make, copy, move, and delete instances from multiple threads at once.
+    Tracker_T tracker{};
+    std::size_t const thread_count = 4;
+    std::size_t const size = 1000;
+    std::vector<std::vector<typename Tracker_T::trackable_ptr> > owners(thread_count);
+    std::vector<std::thread> threads{};
+    std::atomic<std::size_t> failures{0};
+    for (std::size_t t = 0; t != thread_count; ++t)
+    {
+        // Note: Catch2 assertions are not thread-safe, so count failures instead.
+        threads.emplace_back([&tracker, &owner = owners[t], &failures, size]()
+            {
+                using trackable = typename Tracker_T::trackable;
+                for (std::size_t i = 0; i != size; ++i)
+                {
+                    owner.push_back(tracker.make(static_cast<std::int64_t>(i)));
+                    auto && copy = std::make_unique<trackable>(*owner.back());
+                    trackable moved{std::move(*copy)};
+                    failures += not tracker.is_attached(&moved) or copy->is_attached();
+                }
+
+                // Delete half of the instances.
+                for (std::size_t i = 0; i != size; i += 2)
+                {
+                    owner[i].reset();
+                }
+            });
+    }
+    for (auto && thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(failures == 0);
+    std::size_t const remaining = thread_count * size / 2;
+    REQUIRE(tracker.size() == remaining);
+    REQUIRE(tracker.did_make_count == thread_count * size);
+    REQUIRE(tracker.did_attach_count == 2 * thread_count * size);
+    REQUIRE(tracker.did_detach_count == 2 * thread_count * size + thread_count * size / 2);
+
+    // Visit and copy all remaining instances, which should all have odd values.
+    std::size_t visited = 0;
+    tracker.for_each([&visited](test_type & instance)
+        {
+            REQUIRE(instance.value % 2 == 1);
+            ++visited;
+        });
+    REQUIRE(visited == remaining);
+    auto && objects = tracker.snapshot();
+    REQUIRE(objects.size() == remaining);
+
+    // Detach all instances while other threads delete their instances.
+    threads.clear();
+    for (std::size_t t = 0; t != thread_count; ++t)
+    {
+        threads.emplace_back([&owner = owners[t]]()
+            {
+                owner.clear();
+            });
+    }
+    tracker.detach_all();
+    for (auto && thread : threads)
+    {
+        thread.join();
+    }
+    REQUIRE(tracker.size() == 0);
+    REQUIRE(tracker.did_detach_count == 2 * thread_count * size + thread_count * size);
+}
+
+TEST_CASE("Concurrent tracker", "[single-file]")
+{
+    run_concurrent_test<mock_concurrent_tracker>();
+}
+
+TEST_CASE("Concurrent tracker with vector", "[single-file]")
+{
+    run_concurrent_test<mock_concurrent_tracker_with_vector>();
+}
+
+TEST_CASE("Concurrent tracker claims objects that threads race to change", "[single-file]")
+{
+    mock_concurrent_tracker tracker_1{};
+    mock_concurrent_tracker tracker_2{};
+    std::size_t const thread_count = 4;
+    std::size_t const size = 1000;
+    auto && owner = std::vector<mock_concurrent_tracker::trackable_ptr>{};
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        owner.push_back(tracker_1.make());
+    }
+
+    // Every thread tries to detach every object, but each should only be detached once.
+    std::atomic<std::size_t> detached{0};
+    std::vector<std::thread> threads{};
+    for (std::size_t t = 0; t != thread_count; ++t)
+    {
+        threads.emplace_back([&owner, &detached]()
+            {
+                for (auto && instance : owner)
+                {
+                    detached += instance->detach();
+                }
+            });
+    }
+    for (auto && thread : threads)
+    {
+        thread.join();
+    }
+    REQUIRE(detached == size);
+    REQUIRE(tracker_1.did_detach_count == size);
+    REQUIRE(tracker_1.size() == 0);
+
+    // Threads move the same objects back and forth between trackers, and move-construct from them, at the same time.
+    threads.clear();
+    for (std::size_t t = 0; t != thread_count; ++t)
+    {
+        threads.emplace_back([&owner, &tracker_1, &tracker_2, t, thread_count]()
+            {
+                for (std::size_t i = 0; i != owner.size(); ++i)
+                {
+                    auto && instance = owner[(i + t * 7) % owner.size()];
+                    auto && tracker = (i + t) % 2 ? static_cast<mock_concurrent_tracker &>(tracker_1) : tracker_2;
+                    tracker.attach(instance);
+                    if (i % thread_count == t)
+                    {
+                        // Moving back should restore the ownership of the instance in whichever tracker the move took it from.
+                        // Note: only one thread moves each instance, since moving its value is not thread-safe.
+                        auto && own_instance = owner[i];
+                        mock_concurrent_tracker::trackable moved{std::move(*own_instance)};
+                        *own_instance = std::move(moved);
+                    }
+                }
+            });
+    }
+    for (auto && thread : threads)
+    {
+        thread.join();
+    }
+
+    // Each instance should be in exactly the tracker that it points to.
+    auto && objects_1 = tracker_1.snapshot();
+    auto && objects_2 = tracker_2.snapshot();
+    std::set<test_type *> all_objects{};
+    all_objects.insert(std::begin(objects_1), std::end(objects_1));
+    all_objects.insert(std::begin(objects_2), std::end(objects_2));
+    REQUIRE(all_objects.size() == objects_1.size() + objects_2.size());
+    for (auto && instance : owner)
+    {
+        auto && tracker = instance->my_tracker();
+        auto && objects = tracker == &tracker_1 ? objects_1 : objects_2;
+        REQUIRE((not tracker or std::find(std::begin(objects), std::end(objects), instance.get()) != std::end(objects)));
+        REQUIRE((tracker or all_objects.count(instance.get()) == 0));
+    }
+    REQUIRE(tracker_1.did_attach_count - tracker_1.did_detach_count + size == objects_1.size());
+    REQUIRE(tracker_2.did_attach_count - tracker_2.did_detach_count == objects_2.size());
 }
 
 }
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+
+namespace wade {
+
+// Vector that erases in constant time by moving its last value into the erased position.
+// Each value's position is stored in its hook so that erase() never needs to search.
+// Iteration order is therefore not the order of insertion.
+// For example:
+//   TRACKER_WITH_CONTAINER(Mytracker, MyClass, wade::unordered_vector)
+template <typename T>
+class unordered_vector
+{
+    using vector_type = std::vector<T>;
+
+public:
+
+    using value_type = T;
+    using size_type = typename vector_type::size_type;
+    using difference_type = typename vector_type::difference_type;
+    using reference = typename vector_type::reference;
+    using const_reference = typename vector_type::const_reference;
+    using iterator = typename vector_type::const_iterator;
+    using const_iterator = typename vector_type::const_iterator;
+
+    // Position of a value in the vector.
+    using hook_type = size_type;
+
+    // Insert a value at the end and store its position in its hook.
+    template <typename Hook_Of>
+    void insert(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        a_hook_of(a_value) = values_.size();
+        values_.push_back(a_value);
+    }
+
+    // Erase a value by moving the last value into its position, which updates the moved value's hook.
+    template <typename Hook_Of>
+    void erase(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        size_type const index = a_hook_of(a_value);
+        assert(index < values_.size() and values_[index] == a_value);
+        if (index + 1 != values_.size())
+        {
+            values_[index] = values_.back();
+            a_hook_of(values_[index]) = index;
+        }
+        values_.pop_back();
+    }
+
+    // Erase a value by replacing it with a null value, which does not move any other values.
+    template <typename Hook_Of>
+    void erase_deferred(value_type const & a_value, Hook_Of const & a_hook_of)
+    {
+        size_type const index = a_hook_of(a_value);
+        assert(index < values_.size() and values_[index] == a_value);
+        values_[index] = value_type{};
+    }
+
+    // Erase all null values, keeping the other values in order and updating their hooks.
+    template <typename Hook_Of>
+    void compact(Hook_Of const & a_hook_of)
+    {
+        size_type size = 0;
+        for (auto && a_value : values_)
+        {
+            if (a_value)
+            {
+                a_hook_of(a_value) = size;
+                values_[size++] = a_value;
+            }
+        }
+        values_.resize(size);
+    }
+
+    void clear() { values_.clear(); }
+    void reserve(size_type a_capacity) { values_.reserve(a_capacity); }
+
+    const_iterator begin() const { return values_.begin(); }
+    const_iterator end() const { return values_.end(); }
+    const_iterator cbegin() const { return values_.cbegin(); }
+    const_iterator cend() const { return values_.cend(); }
+
+    const_reference operator[](size_type a_index) const { return values_[a_index]; }
+    value_type const * data() const { return values_.data(); }
+
+    size_type size() const { return values_.size(); }
+    size_type capacity() const { return values_.capacity(); }
+    bool empty() const { return values_.empty(); }
+
+private:
+
+    vector_type values_{};
+};
+
+}
+
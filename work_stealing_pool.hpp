@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace wade {
+
+// Fixed number of worker threads that each have their own queue of tasks, and steal tasks from each other when their own queue is empty.
+// Tasks submitted by a worker (i.e., from within a task) go to that worker's queue, which keeps related work on one thread,
+// and tasks submitted by other threads are spread among the workers in turn.
+// Each worker runs its newest task first, and idle workers steal the oldest task of another worker.
+// Tasks may run in any order and at the same time. Destroying the pool waits for all submitted tasks to finish.
+class work_stealing_pool
+{
+public:
+
+    using size_type = std::size_t;
+
+    // Construct with a number of worker threads, which defaults to the number of cores (and is at least 1).
+    explicit work_stealing_pool(size_type a_thread_count = default_thread_count())
+        : queues_(std::max<size_type>(a_thread_count, 1))
+    {
+        for (auto && a_queue : queues_)
+        {
+            a_queue.reset(new queue{});
+        }
+        workers_.reserve(queues_.size());
+        for (size_type i = 0; i != queues_.size(); ++i)
+        {
+            workers_.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    work_stealing_pool(work_stealing_pool const &) = delete;
+    work_stealing_pool & operator=(work_stealing_pool const &) = delete;
+
+    ~work_stealing_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto && a_worker : workers_)
+        {
+            a_worker.join();
+        }
+    }
+
+    // Number of worker threads.
+    size_type size() const { return workers_.size(); }
+
+    // Run a task on a worker thread.
+    // Tasks must not throw, since there is no one to catch an exception.
+    void submit(std::function<void()> a_task)
+    {
+        auto && self = current();
+        auto && a_queue = *queues_[self.pool == this ? self.index : next_++ % queues_.size()];
+        {
+            std::lock_guard<std::mutex> lock{a_queue.mutex};
+            a_queue.tasks.push_back(std::move(a_task));
+        }
+
+        // Note: locking between counting and notifying ensures a worker that is about to wait sees the count instead of missing the notification.
+        ++queued_;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+        }
+        ready_.notify_one();
+    }
+
+    // Number of cores, or 1 if unknown.
+    static size_type default_thread_count()
+    {
+        size_type const cores = std::thread::hardware_concurrency();
+        return cores > 0 ? cores : 1;
+    }
+
+private:
+
+    // Tasks of a worker, which pops the newest task from the back while others steal the oldest from the front.
+    // Allocated separately to keep workers' queues apart in memory.
+    struct queue
+    {
+        std::mutex mutex{};
+        std::deque<std::function<void()> > tasks{};
+    };
+
+    // Worker thread that is running, if any.
+    struct worker
+    {
+        work_stealing_pool * pool = nullptr;
+        size_type index = 0;
+    };
+    static worker & current()
+    {
+        thread_local worker self{};
+        return self;
+    }
+
+    // Run own tasks, or steal others' tasks, until stopping and there are no more tasks.
+    void work(size_type a_index)
+    {
+        current() = worker{this, a_index};
+        std::function<void()> a_task{};
+        for (;;)
+        {
+            if (pop(a_index, a_task) or steal(a_index, a_task))
+            {
+                --queued_;
+                a_task();
+                a_task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock{mutex_};
+            ready_.wait(lock, [this] { return stopping_ or queued_ > 0; });
+            if (stopping_ and queued_ == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    bool pop(size_type a_index, std::function<void()> & a_task)
+    {
+        auto && a_queue = *queues_[a_index];
+        std::lock_guard<std::mutex> lock{a_queue.mutex};
+        if (a_queue.tasks.empty())
+        {
+            return false;
+        }
+        a_task = std::move(a_queue.tasks.back());
+        a_queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_type a_index, std::function<void()> & a_task)
+    {
+        for (size_type i = 1; i != queues_.size(); ++i)
+        {
+            auto && a_queue = *queues_[(a_index + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock{a_queue.mutex};
+            if (not a_queue.tasks.empty())
+            {
+                a_task = std::move(a_queue.tasks.front());
+                a_queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::unique_ptr<queue> > queues_;
+    std::atomic<size_type> next_{0};
+    std::atomic<size_type> queued_{0};
+    std::mutex mutex_{};
+    std::condition_variable ready_{};
+    bool stopping_ = false;
+    std::vector<std::thread> workers_{};
+};
+
+}
+